@@ -0,0 +1,300 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace JMK {
+
+  // Monotonic bump allocator. Memory is carved out of large chunks and is
+  // only returned when the arena is released or destroyed.
+  class arena {
+    struct _chunk {
+      _chunk* m_next;
+      size_t m_size;
+    };
+
+  public:
+    static constexpr size_t default_chunk_size = 64 * 1024;
+
+    explicit arena(size_t chunk_size = default_chunk_size) noexcept
+      : m_chunk_size(std::max<size_t>(chunk_size, sizeof(_chunk) * 2)) {}
+
+    arena(const arena&) = delete;
+    arena(arena&& other) noexcept
+      : m_chunks(other.m_chunks), m_cursor(other.m_cursor), m_limit(other.m_limit),
+      m_chunk_size(other.m_chunk_size), m_used(other.m_used) {
+      other.m_chunks = nullptr;
+      other.m_cursor = nullptr;
+      other.m_limit = nullptr;
+      other.m_used = 0;
+    }
+
+    ~arena() { release(); }
+
+    arena& operator=(const arena&) = delete;
+
+    [[nodiscard]] void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+      std::byte* ptr = _align_up(m_cursor, alignment);
+      if (m_cursor == nullptr || ptr + bytes > m_limit) {
+        _grow(bytes + alignment);
+        ptr = _align_up(m_cursor, alignment);
+      }
+      m_cursor = ptr + bytes;
+      m_used += bytes;
+      return ptr;
+    }
+
+    void deallocate(void*, size_t, size_t = alignof(std::max_align_t)) noexcept {}
+
+    // Frees every chunk at once, invalidating all memory handed out so far
+    void release() noexcept {
+      _chunk* chunk = m_chunks;
+      while (chunk) {
+        _chunk* next = chunk->m_next;
+        ::operator delete(chunk);
+        chunk = next;
+      }
+      m_chunks = nullptr;
+      m_cursor = nullptr;
+      m_limit = nullptr;
+      m_used = 0;
+    }
+
+    [[nodiscard]] size_t bytes_used() const noexcept { return m_used; }
+    [[nodiscard]] size_t chunk_size() const noexcept { return m_chunk_size; }
+
+  private:
+    void _grow(size_t min_bytes) {
+      size_t size = std::max(m_chunk_size, min_bytes + sizeof(_chunk));
+      _chunk* chunk = static_cast<_chunk*>(::operator new(size));
+      chunk->m_next = m_chunks;
+      chunk->m_size = size;
+      m_chunks = chunk;
+      m_cursor = reinterpret_cast<std::byte*>(chunk + 1);
+      m_limit = reinterpret_cast<std::byte*>(chunk) + size;
+    }
+
+    [[nodiscard]] static std::byte* _align_up(std::byte* ptr, size_t alignment) noexcept {
+      uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+      addr = (addr + alignment - 1) & ~(uintptr_t)(alignment - 1);
+      return reinterpret_cast<std::byte*>(addr);
+    }
+
+    _chunk* m_chunks = nullptr;
+    std::byte* m_cursor = nullptr;
+    std::byte* m_limit = nullptr;
+    size_t m_chunk_size;
+    size_t m_used = 0;
+  };
+
+  // Fixed-size block pool. Requests that fit in a block are served from a
+  // free list threaded through chunked storage, larger ones go to the heap.
+  class pool {
+    struct _chunk {
+      _chunk* m_next;
+    };
+
+    struct _free_block {
+      _free_block* m_next;
+    };
+
+  public:
+    static constexpr size_t default_blocks_per_chunk = 256;
+
+    explicit pool(size_t block_size, size_t blocks_per_chunk = default_blocks_per_chunk) noexcept
+      : m_block_size(_round_block_size(block_size)),
+      m_blocks_per_chunk(std::max<size_t>(blocks_per_chunk, 1)) {}
+
+    pool(const pool&) = delete;
+    pool(pool&& other) noexcept
+      : m_chunks(other.m_chunks), m_free(other.m_free), m_block_size(other.m_block_size),
+      m_blocks_per_chunk(other.m_blocks_per_chunk) {
+      other.m_chunks = nullptr;
+      other.m_free = nullptr;
+    }
+
+    ~pool() { release(); }
+
+    pool& operator=(const pool&) = delete;
+
+    [[nodiscard]] void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+      if (bytes > m_block_size || alignment > alignof(std::max_align_t)) {
+        return ::operator new(bytes, std::align_val_t(alignment));
+      }
+      if (m_free == nullptr) {
+        _grow();
+      }
+      _free_block* block = m_free;
+      m_free = block->m_next;
+      return block;
+    }
+
+    void deallocate(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+      if (ptr == nullptr) {
+        return;
+      }
+      if (bytes > m_block_size || alignment > alignof(std::max_align_t)) {
+        ::operator delete(ptr, std::align_val_t(alignment));
+        return;
+      }
+      _free_block* block = static_cast<_free_block*>(ptr);
+      block->m_next = m_free;
+      m_free = block;
+    }
+
+    // Frees every chunk at once, invalidating all blocks handed out so far
+    void release() noexcept {
+      _chunk* chunk = m_chunks;
+      while (chunk) {
+        _chunk* next = chunk->m_next;
+        ::operator delete(chunk);
+        chunk = next;
+      }
+      m_chunks = nullptr;
+      m_free = nullptr;
+    }
+
+    [[nodiscard]] size_t block_size() const noexcept { return m_block_size; }
+    [[nodiscard]] size_t blocks_per_chunk() const noexcept { return m_blocks_per_chunk; }
+
+  private:
+    void _grow() {
+      constexpr size_t header = (sizeof(_chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+      std::byte* raw = static_cast<std::byte*>(::operator new(header + m_block_size * m_blocks_per_chunk));
+
+      _chunk* chunk = reinterpret_cast<_chunk*>(raw);
+      chunk->m_next = m_chunks;
+      m_chunks = chunk;
+
+      // Thread the free list front to back so consecutive allocations are adjacent
+      std::byte* blocks = raw + header;
+      for (size_t i = m_blocks_per_chunk; i > 0; --i) {
+        _free_block* block = reinterpret_cast<_free_block*>(blocks + (i - 1) * m_block_size);
+        block->m_next = m_free;
+        m_free = block;
+      }
+    }
+
+    [[nodiscard]] static constexpr size_t _round_block_size(size_t size) noexcept {
+      size = std::max(size, sizeof(_free_block));
+      return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    }
+
+    _chunk* m_chunks = nullptr;
+    _free_block* m_free = nullptr;
+    size_t m_block_size;
+    size_t m_blocks_per_chunk;
+  };
+
+  // Allocator over malloc/realloc. Containers holding trivially relocatable
+  // elements grow through reallocate(), which can often extend the block in
+  // place instead of copying it.
+  template <typename _T>
+  class malloc_allocator {
+  public:
+    using value_type = _T;
+    using is_always_equal = std::true_type;
+
+    constexpr malloc_allocator() noexcept = default;
+
+    template <typename _U>
+    constexpr malloc_allocator(const malloc_allocator<_U>&) noexcept {}
+
+    [[nodiscard]] _T* allocate(size_t n) {
+      static_assert(alignof(_T) <= alignof(std::max_align_t), "JMK::malloc_allocator cannot over-align");
+      void* ptr = std::malloc(n * sizeof(_T));
+      if (ptr == nullptr) {
+        throw std::bad_alloc();
+      }
+      return static_cast<_T*>(ptr);
+    }
+
+    [[nodiscard]] _T* reallocate(_T* ptr, size_t, size_t new_n) {
+      void* new_ptr = std::realloc(ptr, new_n * sizeof(_T));
+      if (new_ptr == nullptr) {
+        throw std::bad_alloc();
+      }
+      return static_cast<_T*>(new_ptr);
+    }
+
+    void deallocate(_T* ptr, size_t) noexcept {
+      std::free(ptr);
+    }
+
+    template <typename _U>
+    [[nodiscard]] constexpr bool operator==(const malloc_allocator<_U>&) const noexcept {
+      return true;
+    }
+  };
+
+  template <typename _T>
+  class arena_allocator {
+  public:
+    using value_type = _T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    constexpr arena_allocator(JMK::arena& resource) noexcept : m_arena(&resource) {}
+
+    template <typename _U>
+    constexpr arena_allocator(const arena_allocator<_U>& other) noexcept : m_arena(other.resource()) {}
+
+    [[nodiscard]] _T* allocate(size_t n) {
+      return static_cast<_T*>(m_arena->allocate(n * sizeof(_T), alignof(_T)));
+    }
+
+    void deallocate(_T* ptr, size_t n) noexcept {
+      m_arena->deallocate(ptr, n * sizeof(_T), alignof(_T));
+    }
+
+    [[nodiscard]] constexpr JMK::arena* resource() const noexcept { return m_arena; }
+
+    template <typename _U>
+    [[nodiscard]] constexpr bool operator==(const arena_allocator<_U>& other) const noexcept {
+      return m_arena == other.resource();
+    }
+
+  private:
+    JMK::arena* m_arena;
+  };
+
+  template <typename _T>
+  class pool_allocator {
+  public:
+    using value_type = _T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    constexpr pool_allocator(JMK::pool& resource) noexcept : m_pool(&resource) {}
+
+    template <typename _U>
+    constexpr pool_allocator(const pool_allocator<_U>& other) noexcept : m_pool(other.resource()) {}
+
+    [[nodiscard]] _T* allocate(size_t n) {
+      return static_cast<_T*>(m_pool->allocate(n * sizeof(_T), alignof(_T)));
+    }
+
+    void deallocate(_T* ptr, size_t n) noexcept {
+      m_pool->deallocate(ptr, n * sizeof(_T), alignof(_T));
+    }
+
+    [[nodiscard]] constexpr JMK::pool* resource() const noexcept { return m_pool; }
+
+    template <typename _U>
+    [[nodiscard]] constexpr bool operator==(const pool_allocator<_U>& other) const noexcept {
+      return m_pool == other.resource();
+    }
+
+  private:
+    JMK::pool* m_pool;
+  };
+
+}
@@ -6,6 +6,10 @@
 #include <iostream>
 #include <iterator>
 
+#include "compare.hpp"
+#include "hash.hpp"
+#include "simd.hpp"
+
 namespace JMK {
 
   template <typename _T, size_t _N>
@@ -21,7 +25,7 @@ namespace JMK {
       using pointer = value_type*;
       using reference = value_type&;
 
-      constexpr iterator() = delete;
+      constexpr iterator() noexcept = default;
       constexpr iterator(const iterator&) noexcept = default;
       constexpr iterator(iterator&&) noexcept = default;
       constexpr iterator(pointer value) noexcept : m_value(value) {}
@@ -29,7 +33,25 @@ namespace JMK {
       [[nodiscard]] constexpr iterator operator+(difference_type i) const noexcept {
         iterator copy = *this;
         copy.m_value += i;
-        return *copy;
+        return copy;
+      }
+
+      [[nodiscard]] friend constexpr iterator operator+(difference_type i, const iterator& it) noexcept {
+        return it + i;
+      }
+
+      constexpr iterator& operator+=(difference_type i) noexcept {
+        m_value += i;
+        return *this;
+      }
+
+      constexpr iterator& operator-=(difference_type i) noexcept {
+        m_value -= i;
+        return *this;
+      }
+
+      [[nodiscard]] constexpr reference operator[](difference_type i) const noexcept {
+        return m_value[i];
       }
 
       constexpr iterator& operator++() noexcept {
@@ -37,7 +59,7 @@ namespace JMK {
         return *this;
       }
 
-      constexpr iterator& operator++(int) noexcept {
+      constexpr iterator operator++(int) noexcept {
         iterator copy = *this;
         ++m_value;
         return copy;
@@ -46,7 +68,7 @@ namespace JMK {
       [[nodiscard]] constexpr iterator operator-(difference_type i) const noexcept {
         iterator copy = *this;
         copy.m_value -= i;
-        return *copy;
+        return copy;
       }
 
       [[nodiscard]] constexpr difference_type operator-(const iterator& other) const noexcept {
@@ -58,17 +80,17 @@ namespace JMK {
         return *this;
       }
 
-      constexpr iterator& operator--(int) noexcept {
+      constexpr iterator operator--(int) noexcept {
         iterator copy = *this;
         --m_value;
         return copy;
       }
 
-      [[nodiscard]] constexpr reference operator*() noexcept {
+      [[nodiscard]] constexpr reference operator*() const noexcept {
         return *m_value;
       }
 
-      [[nodiscard]] constexpr pointer operator->() noexcept {
+      [[nodiscard]] constexpr pointer operator->() const noexcept {
         return m_value;
       }
 
@@ -79,28 +101,45 @@ namespace JMK {
       [[nodiscard]] constexpr std::strong_ordering operator<=>(const iterator& other) const& = default;
 
     private:
-      pointer m_value;
+      pointer m_value = nullptr;
     };
 
     class const_iterator {
     public:
       using iterator_category = std::contiguous_iterator_tag;
-      using value_type = std::remove_reference_t<const _T>;
+      using value_type = std::remove_reference_t<_T>;
       using difference_type = std::ptrdiff_t;
-      using pointer = value_type*;
-      using reference = value_type&;
+      using pointer = const value_type*;
+      using reference = const value_type&;
 
-      constexpr const_iterator() = delete;
+      constexpr const_iterator() noexcept = default;
       constexpr const_iterator(const const_iterator&) noexcept = default;
       constexpr const_iterator(const_iterator&&) noexcept = default;
-      constexpr const_iterator(const iterator& other) noexcept : m_data(std::addressof(*other)) {}
-      constexpr const_iterator(iterator&& other) noexcept : m_data(std::addressof(*other)) {}
+      constexpr const_iterator(const iterator& other) noexcept : m_value(other.operator->()) {}
       constexpr const_iterator(pointer value) noexcept : m_value(value) {}
 
       [[nodiscard]] constexpr const_iterator operator+(difference_type i) const noexcept {
         const_iterator copy = *this;
         copy.m_value += i;
-        return *copy;
+        return copy;
+      }
+
+      [[nodiscard]] friend constexpr const_iterator operator+(difference_type i, const const_iterator& it) noexcept {
+        return it + i;
+      }
+
+      constexpr const_iterator& operator+=(difference_type i) noexcept {
+        m_value += i;
+        return *this;
+      }
+
+      constexpr const_iterator& operator-=(difference_type i) noexcept {
+        m_value -= i;
+        return *this;
+      }
+
+      [[nodiscard]] constexpr reference operator[](difference_type i) const noexcept {
+        return m_value[i];
       }
 
       constexpr const_iterator& operator++() noexcept {
@@ -108,7 +147,7 @@ namespace JMK {
         return *this;
       }
 
-      constexpr const_iterator& operator++(int) noexcept {
+      constexpr const_iterator operator++(int) noexcept {
         const_iterator copy = *this;
         ++m_value;
         return copy;
@@ -117,7 +156,7 @@ namespace JMK {
       [[nodiscard]] constexpr const_iterator operator-(difference_type i) const noexcept {
         const_iterator copy = *this;
         copy.m_value -= i;
-        return *copy;
+        return copy;
       }
 
       [[nodiscard]] constexpr difference_type operator-(const const_iterator& other) const noexcept {
@@ -129,30 +168,32 @@ namespace JMK {
         return *this;
       }
 
-      constexpr const_iterator& operator--(int) noexcept {
+      constexpr const_iterator operator--(int) noexcept {
         const_iterator copy = *this;
         --m_value;
         return copy;
       }
 
-      [[nodiscard]] constexpr reference operator*() noexcept {
+      [[nodiscard]] constexpr reference operator*() const noexcept {
         return *m_value;
       }
 
-      [[nodiscard]] constexpr pointer operator->() noexcept {
+      [[nodiscard]] constexpr pointer operator->() const noexcept {
         return m_value;
       }
 
       constexpr const_iterator& operator=(const const_iterator& other) noexcept = default;
       constexpr const_iterator& operator=(const_iterator&& other) noexcept = default;
-      constexpr const_iterator& operator=(const iterator& other) noexcept { return const_iterator(other); }
-      constexpr const_iterator& operator=(iterator&& other) noexcept { return const_iterator(std::move(other)); }
+      constexpr const_iterator& operator=(const iterator& other) noexcept {
+        m_value = other.operator->();
+        return *this;
+      }
 
       [[nodiscard]] constexpr bool operator==(const const_iterator& other) const& = default;
       [[nodiscard]] constexpr std::strong_ordering operator<=>(const const_iterator& other) const& = default;
 
     private:
-      pointer m_value;
+      pointer m_value = nullptr;
     };
 
     using reverse_iterator = std::reverse_iterator<iterator>;
@@ -161,7 +202,7 @@ namespace JMK {
     constexpr array() noexcept(std::is_trivially_constructible_v<_T>) : array(_T()) {}
 
     template <typename _U, size_t _S>
-    constexpr array(const array<_U, _S>& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr array(const array<_U, _S>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_copy_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) {
@@ -171,7 +212,7 @@ namespace JMK {
     }
 
     template <typename _U, size_t _S>
-    constexpr array(array<_U, _S>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr array(array<_U, _S>&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_move_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) {
@@ -215,19 +256,22 @@ namespace JMK {
       return m_data[index];
     }
 
-    [[nodiscard]] constexpr iterator begin() noexcept { return &m_data[0]; }
-    [[nodiscard]] constexpr iterator end() noexcept { return &m_data[_N - 1]; }
-    [[nodiscard]] constexpr const_iterator begin() const noexcept { return &m_data[0]; }
-    [[nodiscard]] constexpr const_iterator end() const noexcept { return &m_data[_N - 1]; }
+    [[nodiscard]] constexpr _T* data() noexcept { return m_data; }
+    [[nodiscard]] constexpr const _T* data() const noexcept { return m_data; }
 
-    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return &m_data[0]; }
-    [[nodiscard]] constexpr const_iterator cend() const noexcept { return &m_data[_N - 1]; }
+    [[nodiscard]] constexpr iterator begin() noexcept { return m_data; }
+    [[nodiscard]] constexpr iterator end() noexcept { return m_data + _N; }
+    [[nodiscard]] constexpr const_iterator begin() const noexcept { return m_data; }
+    [[nodiscard]] constexpr const_iterator end() const noexcept { return m_data + _N; }
 
-    [[nodiscard]] constexpr reverse_iterator rbegin() noexcept { return &m_data[_N - 1]; }
-    [[nodiscard]] constexpr reverse_iterator rend() noexcept { return &m_data[0]; }
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return m_data; }
+    [[nodiscard]] constexpr const_iterator cend() const noexcept { return m_data + _N; }
 
-    [[nodiscard]] constexpr reverse_iterator crbegin() const noexcept { return &m_data[_N - 1]; }
-    [[nodiscard]] constexpr reverse_iterator crend() const noexcept { return &m_data[0]; }
+    [[nodiscard]] constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    [[nodiscard]] constexpr reverse_const_iterator crbegin() const noexcept { return reverse_const_iterator(cend()); }
+    [[nodiscard]] constexpr reverse_const_iterator crend() const noexcept { return reverse_const_iterator(cbegin()); }
 
     [[nodiscard]] constexpr _T& front() { return at(0); }
     [[nodiscard]] constexpr const _T& front() const { return at(0); }
@@ -237,6 +281,12 @@ namespace JMK {
 
     constexpr void fill(_T v) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) {
+      if constexpr (JMK::simd::arithmetic<_T>) {
+        if (!std::is_constant_evaluated()) {
+          JMK::simd::fill(m_data, _N, v);
+          return;
+        }
+      }
       for (size_t i = 0; i < _N; ++i) {
         m_data[i] = v;
       }
@@ -248,7 +298,7 @@ namespace JMK {
     }
 
     template<typename _U, size_t _S>
-    JMK::array<_T, _N>& operator =(const JMK::array<_U, _S>& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    JMK::array<_T, _N>& operator =(const JMK::array<_U, _S>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_copy_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) {
@@ -258,7 +308,7 @@ namespace JMK {
     }
 
     template<typename _U, size_t _S>
-    JMK::array<_T, _N>& operator =(JMK::array<_U, _S>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    JMK::array<_T, _N>& operator =(JMK::array<_U, _S>&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_move_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) {
@@ -267,6 +317,14 @@ namespace JMK {
       }
     }
 
+    [[nodiscard]] constexpr bool operator==(const array& other) const requires std::equality_comparable<_T> {
+      return JMK::equal_ranges(data(), _N, other.data(), other.size());
+    }
+
+    [[nodiscard]] constexpr auto operator<=>(const array& other) const requires std::three_way_comparable<_T> {
+      return JMK::compare_ranges(data(), _N, other.data(), other.size());
+    }
+
     [[nodiscard]] explicit operator std::string() const noexcept {
       std::string out;
       for (size_t i = 0; i < _N; ++i) {
@@ -303,4 +361,12 @@ namespace JMK {
     return os;
   }
 
-}
\ No newline at end of file
+}
+
+template <typename _T, size_t _N>
+  requires JMK::range_hashable<_T>
+struct std::hash<JMK::array<_T, _N>> {
+  [[nodiscard]] size_t operator()(const JMK::array<_T, _N>& value) const noexcept {
+    return JMK::hash_range(value.data(), value.size());
+  }
+};
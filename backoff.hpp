@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace JMK {
+
+  // Hints the core that the caller is busy waiting
+  inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+  }
+
+  // Exponential backoff for retry loops. spin() only ever pauses the core and
+  // suits failed CAS retries; snooze() moves on to yielding the thread once
+  // spinning stops paying off, and is_completed() reports when the caller
+  // should block instead.
+  class backoff {
+  public:
+    static constexpr uint32_t spin_limit = 6;
+    static constexpr uint32_t yield_limit = 10;
+
+    void spin() noexcept {
+      for (uint32_t i = 0; i < (1u << std::min(m_step, spin_limit)); ++i) {
+        cpu_relax();
+      }
+      if (m_step <= spin_limit) {
+        m_step += 1;
+      }
+    }
+
+    void snooze() noexcept {
+      if (m_step <= spin_limit) {
+        for (uint32_t i = 0; i < (1u << m_step); ++i) {
+          cpu_relax();
+        }
+      }
+      else {
+        std::this_thread::yield();
+      }
+      if (m_step <= yield_limit) {
+        m_step += 1;
+      }
+    }
+
+    [[nodiscard]] bool is_completed() const noexcept { return m_step > yield_limit; }
+
+    void reset() noexcept { m_step = 0; }
+
+  private:
+    uint32_t m_step = 0;
+  };
+
+}
@@ -0,0 +1,375 @@
+// Compares two JSON result files written by a benchmark's --json and flags
+// the statistically significant regressions.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 compare.cpp -o compare
+//
+// and run ./compare BASELINE.json CANDIDATE.json [--alpha=P] [--threshold=PCT].
+// Benchmarks are matched on suite, operation, implementation, element_size
+// and count. A change is significant when a two-sided Mann-Whitney U test on
+// the per run times gives p < alpha (0.01 by default) and the medians differ
+// by more than threshold percent (5 by default). Small samples without ties
+// use the exact distribution of U. The exit status is 1 when any benchmark
+// regressed, and otherwise 3 when some pair of sample sizes is too small
+// for any result to reach alpha.
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  // One benchmark of a result file. Only the fields compare needs are kept.
+  struct entry {
+    std::string key;
+    double median = 0;
+    std::optional<double> instructions;
+    std::vector<double> samples;
+  };
+
+  // Just enough JSON for the harness output: an array of flat objects whose
+  // values are strings, numbers, null or arrays of numbers
+  class reader {
+  public:
+    explicit reader(std::string text) : m_text(std::move(text)) {}
+
+    bool parse(std::vector<entry>& out) {
+      if (!_consume('[')) {
+        return false;
+      }
+      if (_consume(']')) {
+        return true;
+      }
+      do {
+        entry e;
+        if (!_object(e)) {
+          return false;
+        }
+        out.push_back(std::move(e));
+      } while (_consume(','));
+      return _consume(']');
+    }
+
+  private:
+    bool _object(entry& e) {
+      if (!_consume('{')) {
+        return false;
+      }
+      std::map<std::string, std::string> names;
+      std::string element_size, count;
+      do {
+        std::string field;
+        if (!_string(field) || !_consume(':')) {
+          return false;
+        }
+        _skip_space();
+        if (_peek() == '"') {
+          std::string value;
+          if (!_string(value)) {
+            return false;
+          }
+          names[field] = value;
+        }
+        else if (_peek() == '[') {
+          ++m_pos;
+          if (!_consume(']')) {
+            do {
+              double v;
+              if (!_number(v)) {
+                return false;
+              }
+              if (field == "samples_ns_per_op") {
+                e.samples.push_back(v);
+              }
+            } while (_consume(','));
+            if (!_consume(']')) {
+              return false;
+            }
+          }
+        }
+        else if (m_text.compare(m_pos, 4, "null") == 0) {
+          m_pos += 4;
+        }
+        else {
+          size_t start = m_pos;
+          double v;
+          if (!_number(v)) {
+            return false;
+          }
+          if (field == "median_ns_per_op") {
+            e.median = v;
+          }
+          else if (field == "instructions_per_op") {
+            e.instructions = v;
+          }
+          else if (field == "element_size") {
+            element_size = m_text.substr(start, m_pos - start);
+          }
+          else if (field == "count") {
+            count = m_text.substr(start, m_pos - start);
+          }
+        }
+      } while (_consume(','));
+      e.key = names["suite"] + "/" + names["operation"] + "/" + names["implementation"] +
+        " size=" + element_size + " count=" + count;
+      return _consume('}');
+    }
+
+    bool _string(std::string& out) {
+      if (!_consume('"')) {
+        return false;
+      }
+      while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+        if (m_text[m_pos] == '\\' && m_pos + 1 < m_text.size()) {
+          ++m_pos;
+        }
+        out += m_text[m_pos++];
+      }
+      return _consume('"');
+    }
+
+    bool _number(double& out) {
+      _skip_space();
+      const char* begin = m_text.c_str() + m_pos;
+      char* end = nullptr;
+      out = std::strtod(begin, &end);
+      if (end == begin) {
+        return false;
+      }
+      m_pos += static_cast<size_t>(end - begin);
+      return true;
+    }
+
+    bool _consume(char c) {
+      _skip_space();
+      if (_peek() != c) {
+        return false;
+      }
+      ++m_pos;
+      return true;
+    }
+
+    char _peek() const noexcept { return m_pos < m_text.size() ? m_text[m_pos] : '\0'; }
+
+    void _skip_space() noexcept {
+      while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+        ++m_pos;
+      }
+    }
+
+    std::string m_text;
+    size_t m_pos = 0;
+  };
+
+  bool load(const char* path, std::vector<entry>& out) {
+    std::ifstream file(path);
+    if (!file) {
+      std::fprintf(stderr, "compare: cannot open %s\n", path);
+      return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    if (!reader(text.str()).parse(out)) {
+      std::fprintf(stderr, "compare: %s is not a benchmark JSON result\n", path);
+      return false;
+    }
+    return true;
+  }
+
+  // Samples up to this size use the exact null distribution of U, where the
+  // normal approximation is too coarse: with 5 runs a side its smallest p is
+  // above 0.01, while the exact one is 2 / C(10, 5) = 0.008
+  constexpr size_t exact_limit = 30;
+
+  // Two-sided p-value of U for samples of n1 and n2 without ties, from the
+  // number of orderings of the pooled sample that give each value of U
+  double exact_p(double u, size_t n1, size_t n2) {
+    size_t max_u = n1 * n2;
+    // ways[i][j][k]: orderings of the i smallest of a and j smallest of b
+    // in which a wins k comparisons
+    std::vector<std::vector<double>> ways((n1 + 1) * (n2 + 1));
+    for (size_t i = 0; i <= n1; ++i) {
+      for (size_t j = 0; j <= n2; ++j) {
+        std::vector<double>& w = ways[i * (n2 + 1) + j];
+        w.assign(i * j + 1, 0);
+        if (i == 0 || j == 0) {
+          w[0] = 1;
+          continue;
+        }
+        // The largest element comes from a, beating all j of b, or from b
+        const std::vector<double>& from_a = ways[(i - 1) * (n2 + 1) + j];
+        const std::vector<double>& from_b = ways[i * (n2 + 1) + j - 1];
+        for (size_t k = 0; k < from_a.size(); ++k) {
+          w[k + j] += from_a[k];
+        }
+        for (size_t k = 0; k < from_b.size(); ++k) {
+          w[k] += from_b[k];
+        }
+      }
+    }
+    const std::vector<double>& count = ways.back();
+    double total = 0, tail = 0;
+    double low = std::min(u, static_cast<double>(max_u) - u);
+    for (size_t k = 0; k <= max_u; ++k) {
+      total += count[k];
+      if (static_cast<double>(k) <= low) {
+        tail += count[k];
+      }
+    }
+    return std::min(1.0, 2 * tail / total);
+  }
+
+  // Two-sided p-value of the Mann-Whitney U test for statistic u, exact for
+  // small samples without ties and from the normal approximation with a tie
+  // correction otherwise. ties is the sum of t^3 - t over groups of t tied
+  // values.
+  double u_test_p(double u, size_t size1, size_t size2, double ties) {
+    if (ties == 0 && size1 <= exact_limit && size2 <= exact_limit) {
+      return exact_p(u, size1, size2);
+    }
+    const double n1 = static_cast<double>(size1);
+    const double n2 = static_cast<double>(size2);
+    const double n = n1 + n2;
+    double mean = n1 * n2 / 2;
+    double variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+    if (variance <= 0) {
+      return 1;
+    }
+    double z = (std::abs(u - mean) - 0.5) / std::sqrt(variance);
+    return std::erfc(std::max(z, 0.0) / std::sqrt(2.0));
+  }
+
+  // The p-value of two samples that do not overlap at all, below which no
+  // pair of samples of these sizes can go
+  double smallest_p(size_t n1, size_t n2) {
+    return n1 == 0 || n2 == 0 ? 1 : u_test_p(0, n1, n2, 0);
+  }
+
+  // Two-sided p-value of the Mann-Whitney U test. Robust to the long right
+  // tail that timing samples have, which a t-test is not.
+  double mann_whitney_p(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.empty() || b.empty()) {
+      return 1;
+    }
+    std::vector<std::pair<double, int>> all;
+    for (double v : a) {
+      all.emplace_back(v, 0);
+    }
+    for (double v : b) {
+      all.emplace_back(v, 1);
+    }
+    std::sort(all.begin(), all.end());
+
+    double rank_sum = 0;
+    double ties = 0;
+    for (size_t i = 0; i < all.size();) {
+      size_t j = i;
+      while (j < all.size() && all[j].first == all[i].first) {
+        ++j;
+      }
+      // Tied values share the mean of the ranks they span
+      double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2;
+      for (size_t k = i; k < j; ++k) {
+        if (all[k].second == 0) {
+          rank_sum += rank;
+        }
+      }
+      double t = static_cast<double>(j - i);
+      ties += t * t * t - t;
+      i = j;
+    }
+
+    const double n1 = static_cast<double>(a.size());
+    return u_test_p(rank_sum - n1 * (n1 + 1) / 2, a.size(), b.size(), ties);
+  }
+
+}
+
+int main(int argc, char** argv) {
+  const char* paths[2] = {};
+  size_t npaths = 0;
+  double alpha = 0.01;
+  double threshold = 5;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg.starts_with("--alpha=")) {
+      alpha = std::stod(std::string(arg.substr(8)));
+    }
+    else if (arg.starts_with("--threshold=")) {
+      threshold = std::stod(std::string(arg.substr(12)));
+    }
+    else if (!arg.starts_with("--") && npaths < 2) {
+      paths[npaths++] = argv[i];
+    }
+    else {
+      npaths = 0;
+      break;
+    }
+  }
+  if (npaths != 2) {
+    std::fprintf(stderr, "usage: %s BASELINE.json CANDIDATE.json [--alpha=P] [--threshold=PCT]\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<entry> baseline, candidate;
+  if (!load(paths[0], baseline) || !load(paths[1], candidate)) {
+    return 2;
+  }
+  std::map<std::string, const entry*> by_key;
+  for (const entry& e : baseline) {
+    by_key[e.key] = &e;
+  }
+
+  size_t regressions = 0, improvements = 0, undecidable = 0;
+  std::printf("%-60s %12s %12s %8s %9s %10s  %s\n", "benchmark", "base_ns", "new_ns", "change", "p", "instr", "verdict");
+  for (const entry& cand : candidate) {
+    auto it = by_key.find(cand.key);
+    if (it == by_key.end()) {
+      continue;
+    }
+    const entry& base = *it->second;
+    double change = base.median > 0 ? (cand.median / base.median - 1) * 100 : 0;
+    double p = mann_whitney_p(base.samples, cand.samples);
+
+    const char* verdict = "";
+    if (smallest_p(base.samples.size(), cand.samples.size()) >= alpha) {
+      // Not even a complete separation of the runs would be significant
+      verdict = "too few runs";
+      undecidable += 1;
+    }
+    else if (p < alpha && std::abs(change) > threshold) {
+      verdict = change > 0 ? "REGRESSION" : "improvement";
+      (change > 0 ? regressions : improvements) += 1;
+    }
+
+    // Instruction counts are far less noisy than time and point at whether
+    // a change did more work or just ran slower
+    char instructions[16] = "-";
+    if (base.instructions && cand.instructions && *base.instructions > 0) {
+      std::snprintf(instructions, sizeof(instructions), "%+.1f%%", (*cand.instructions / *base.instructions - 1) * 100);
+    }
+    std::printf("%-60s %12.3f %12.3f %+7.1f%% %9.2g %10s  %s\n", cand.key.c_str(), base.median, cand.median, change,
+      p, instructions, verdict);
+  }
+  std::printf("\n%zu regression(s), %zu improvement(s) at alpha=%g, threshold=%g%%\n", regressions, improvements,
+    alpha, threshold);
+  if (undecidable > 0) {
+    std::fprintf(stderr, "compare: %zu benchmark(s) have too few runs to be significant at alpha=%g; "
+      "rerun with a larger --min-runs\n", undecidable, alpha);
+  }
+  if (regressions > 0) {
+    return 1;
+  }
+  return undecidable > 0 ? 3 : 0;
+}
@@ -0,0 +1,115 @@
+// Measures JMK::concurrent_stack under contention from 1 thread up to the
+// number of hardware threads, against JMK::stack behind a mutex.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 -DNDEBUG -I.. concurrent_stack.cpp -o concurrent_stack -pthread
+//
+// and run ./concurrent_stack [--filter=concurrent_stack/push_pop] [--min-time=MS]
+// [--json].
+// In "push_pop" every thread alternates a push with a pop, the pattern the
+// elimination array pairs up; in "burst" every thread pushes a batch and then
+// pops as many, so the head really grows and shrinks. Count is the number of
+// threads; times are per push or pop, over all threads together.
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../concurrent_stack.hpp"
+#include "../stack.hpp"
+#include "harness.hpp"
+#include "threads.hpp"
+
+namespace {
+
+  using JMK::bench::benchmark;
+  using JMK::bench::keep;
+  using JMK::bench::stopwatch;
+
+  constexpr size_t operations_per_run = 1 << 16;
+  constexpr size_t burst = 64;
+
+  // The baseline: the growable JMK::stack with every operation under one lock
+  class locked_stack {
+  public:
+    void push(uint64_t item) {
+      std::lock_guard lock(m_mutex);
+      m_stack.push(item);
+    }
+
+    bool try_pop(uint64_t& out) {
+      std::lock_guard lock(m_mutex);
+      if (m_stack.empty()) {
+        return false;
+      }
+      out = m_stack.pop();
+      return true;
+    }
+
+  private:
+    std::mutex m_mutex;
+    JMK::stack<uint64_t, 0> m_stack;
+  };
+
+  template <typename _Stack>
+  size_t push_pop(stopwatch& sw, size_t threads) {
+    auto stack = std::make_unique<_Stack>();
+    size_t pairs = operations_per_run / 2 / threads;
+    JMK::bench::run_threads(sw, threads, [&](size_t id) {
+      uint64_t sum = 0, out;
+      for (size_t i = 0; i < pairs; ++i) {
+        stack->push(id + i);
+        if (stack->try_pop(out)) {
+          sum += out;
+        }
+      }
+      keep(sum);
+    });
+    return 2 * pairs * threads;
+  }
+
+  template <typename _Stack>
+  size_t burst_push_pop(stopwatch& sw, size_t threads) {
+    auto stack = std::make_unique<_Stack>();
+    size_t rounds = operations_per_run / (2 * burst) / threads;
+    JMK::bench::run_threads(sw, threads, [&](size_t id) {
+      uint64_t sum = 0, out;
+      for (size_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < burst; ++i) {
+          stack->push(id + i);
+        }
+        for (size_t i = 0; i < burst; ++i) {
+          if (stack->try_pop(out)) {
+            sum += out;
+          }
+        }
+      }
+      keep(sum);
+    });
+    return 2 * burst * rounds * threads;
+  }
+
+}
+
+int main(int argc, char** argv) {
+  JMK::bench::options opts;
+  if (!JMK::bench::parse_options(argc, argv, opts)) {
+    return 2;
+  }
+  std::vector<benchmark> benchmarks;
+  for (size_t threads : JMK::bench::thread_counts()) {
+    auto add = [&](const char* op, const char* impl, size_t (*run)(stopwatch&, size_t)) {
+      benchmarks.push_back({ "concurrent_stack", op, impl, sizeof(uint64_t), threads,
+        [run, threads](stopwatch& sw) { return run(sw, threads); } });
+    };
+    add("push_pop", "jmk", push_pop<JMK::concurrent_stack<uint64_t>>);
+    add("push_pop", "mutex", push_pop<locked_stack>);
+    add("burst", "jmk", burst_push_pop<JMK::concurrent_stack<uint64_t>>);
+    add("burst", "mutex", burst_push_pop<locked_stack>);
+  }
+  JMK::bench::run_all(benchmarks, opts);
+  return 0;
+}
@@ -0,0 +1,326 @@
+// Compares the JMK containers against their standard library counterparts.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 -DNDEBUG -I.. containers.cpp -o containers
+//
+// and run ./containers [--filter=vector/push_back] [--min-time=MS] [--json]
+// [--no-counters].
+// Every row is one container operation at one element size and count; times
+// are per operation, so JMK and std rows with the same suite, operation,
+// element_size and count compare directly.
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <queue>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "../array.hpp"
+#include "../list.hpp"
+#include "../queue.hpp"
+#include "../stack.hpp"
+#include "../vector.hpp"
+#include "harness.hpp"
+
+namespace {
+
+  using JMK::bench::benchmark;
+  using JMK::bench::keep;
+  using JMK::bench::stopwatch;
+
+  // An element _Bytes wide whose first word carries a value
+  template <size_t _Bytes>
+  struct payload {
+    payload() noexcept = default;
+    payload(uint32_t value) noexcept : words{ value } {}
+
+    std::array<uint32_t, _Bytes / sizeof(uint32_t)> words{};
+  };
+
+  uint32_t value_of(uint32_t v) noexcept { return v; }
+
+  template <size_t _Bytes>
+  uint32_t value_of(const payload<_Bytes>& p) noexcept { return p.words[0]; }
+
+  // Operations timed per benchmark where each one costs O(count)
+  constexpr size_t positional_ops = 100;
+
+  template <typename _Vec>
+  void add_vector(std::vector<benchmark>& out, const char* impl, size_t elem, size_t n) {
+    auto add = [&](const char* op, std::function<size_t(stopwatch&)> run) {
+      out.push_back({ "vector", op, impl, elem, n, std::move(run) });
+    };
+    add("push_back", [n](stopwatch& sw) {
+      _Vec v;
+      keep(v);
+      sw.start();
+      for (size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<uint32_t>(i));
+      }
+      sw.stop();
+      keep(v);
+      return n;
+    });
+    add("emplace_back", [n](stopwatch& sw) {
+      _Vec v;
+      keep(v);
+      sw.start();
+      for (size_t i = 0; i < n; ++i) {
+        v.emplace_back(static_cast<uint32_t>(i));
+      }
+      sw.stop();
+      keep(v);
+      return n;
+    });
+    add("insert_middle", [n](stopwatch& sw) {
+      _Vec v;
+      v.resize(n);
+      keep(v);
+      sw.start();
+      for (size_t i = 0; i < positional_ops; ++i) {
+        v.insert(v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2), static_cast<uint32_t>(i));
+      }
+      sw.stop();
+      keep(v);
+      return positional_ops;
+    });
+    add("erase_middle", [n](stopwatch& sw) {
+      _Vec v;
+      v.resize(n + positional_ops);
+      keep(v);
+      sw.start();
+      for (size_t i = 0; i < positional_ops; ++i) {
+        v.erase(v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2));
+      }
+      sw.stop();
+      keep(v);
+      return positional_ops;
+    });
+    add("iterate", [n](stopwatch& sw) {
+      _Vec v;
+      for (size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<uint32_t>(i));
+      }
+      uint64_t sum = 0;
+      keep(v);
+      sw.start();
+      for (const auto& item : v) {
+        sum += value_of(item);
+      }
+      sw.stop();
+      keep(sum);
+      return n;
+    });
+    add("resize", [n](stopwatch& sw) {
+      _Vec v;
+      keep(v);
+      sw.start();
+      v.resize(n);
+      sw.stop();
+      keep(v);
+      return n;
+    });
+  }
+
+  template <typename _List>
+  void add_list(std::vector<benchmark>& out, const char* impl, size_t elem, size_t n) {
+    auto add = [&](const char* op, std::function<size_t(stopwatch&)> run) {
+      out.push_back({ "list", op, impl, elem, n, std::move(run) });
+    };
+    auto filled = [n] {
+      _List l;
+      for (size_t i = 0; i < n; ++i) {
+        l.push_back(static_cast<uint32_t>(i));
+      }
+      return l;
+    };
+    add("insert", [n](stopwatch& sw) {
+      _List l;
+      keep(l);
+      sw.start();
+      for (size_t i = 0; i < n; ++i) {
+        l.insert(l.begin(), static_cast<uint32_t>(i));
+      }
+      sw.stop();
+      keep(l);
+      return n;
+    });
+    add("erase", [n, filled](stopwatch& sw) {
+      _List l = filled();
+      keep(l);
+      sw.start();
+      while (l.begin() != l.end()) {
+        l.erase(l.begin());
+      }
+      sw.stop();
+      keep(l);
+      return n;
+    });
+    add("iterate", [n, filled](stopwatch& sw) {
+      _List l = filled();
+      uint64_t sum = 0;
+      keep(l);
+      sw.start();
+      for (const auto& item : l) {
+        sum += value_of(item);
+      }
+      sw.stop();
+      keep(sum);
+      return n;
+    });
+    add("at", [n, filled](stopwatch& sw) {
+      _List l = filled();
+      uint64_t sum = 0;
+      uint64_t seed = 12345;
+      keep(l);
+      sw.start();
+      for (size_t i = 0; i < positional_ops; ++i) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        size_t index = (seed >> 33) % n;
+        if constexpr (requires { l.at(index); }) {
+          sum += value_of(l.at(index));
+        }
+        else {
+          sum += value_of(*std::next(l.begin(), static_cast<std::ptrdiff_t>(index)));
+        }
+      }
+      sw.stop();
+      keep(sum);
+      return positional_ops;
+    });
+  }
+
+  // std::stack and std::queue pop without returning, the JMK ones return
+  template <typename _C>
+  void take(_C& c) {
+    if constexpr (requires { c.dequeue(); }) {
+      keep(c.dequeue());
+    }
+    else if constexpr (requires { c.front(); c.pop(); }) {
+      keep(c.front());
+      c.pop();
+    }
+    else if constexpr (std::is_void_v<decltype(c.pop())>) {
+      keep(c.top());
+      c.pop();
+    }
+    else {
+      keep(c.pop());
+    }
+  }
+
+  template <typename _C, typename _V>
+  void put(_C& c, _V&& value) {
+    if constexpr (requires { c.enqueue(std::forward<_V>(value)); }) {
+      c.enqueue(std::forward<_V>(value));
+    }
+    else {
+      c.push(std::forward<_V>(value));
+    }
+  }
+
+  // Stacks and queues in steady state, where every put is matched by a take
+  // around a constant size, and across growth, where they fill up from empty
+  // through every reallocation and then drain
+  template <typename _C, typename _T>
+  void add_adapter(std::vector<benchmark>& out, const char* suite, const char* impl, size_t n) {
+    auto add = [&](const char* op, std::function<size_t(stopwatch&)> run) {
+      out.push_back({ suite, op, impl, sizeof(_T), n, std::move(run) });
+    };
+    add("steady_state", [n](stopwatch& sw) {
+      _C c;
+      for (size_t i = 0; i < n; ++i) {
+        put(c, _T(static_cast<uint32_t>(i)));
+      }
+      keep(c);
+      sw.start();
+      for (size_t i = 0; i < n; ++i) {
+        put(c, _T(static_cast<uint32_t>(i)));
+        take(c);
+      }
+      sw.stop();
+      return n;
+    });
+    add("growth", [n](stopwatch& sw) {
+      _C c;
+      keep(c);
+      sw.start();
+      for (size_t i = 0; i < n; ++i) {
+        put(c, _T(static_cast<uint32_t>(i)));
+      }
+      for (size_t i = 0; i < n; ++i) {
+        take(c);
+      }
+      sw.stop();
+      return 2 * n;
+    });
+  }
+
+  template <typename _Array, typename _T>
+  void add_array(std::vector<benchmark>& out, const char* impl, size_t n) {
+    auto add = [&](const char* op, std::function<size_t(stopwatch&)> run) {
+      out.push_back({ "array", op, impl, sizeof(_T), n, std::move(run) });
+    };
+    add("fill", [n](stopwatch& sw) {
+      auto a = std::make_unique<_Array>();
+      keep(*a);
+      sw.start();
+      a->fill(_T(7));
+      sw.stop();
+      keep(*a);
+      return n;
+    });
+    add("copy", [n](stopwatch& sw) {
+      auto a = std::make_unique<_Array>();
+      auto b = std::make_unique<_Array>();
+      a->fill(_T(7));
+      keep(*a);
+      keep(*b);
+      sw.start();
+      *b = *a;
+      sw.stop();
+      keep(*b);
+      return n;
+    });
+  }
+
+  template <typename _T>
+  void add_element(std::vector<benchmark>& out) {
+    for (size_t n : { size_t(1000), size_t(100000) }) {
+      add_vector<JMK::vector<_T>>(out, "jmk", sizeof(_T), n);
+      add_vector<std::vector<_T>>(out, "std", sizeof(_T), n);
+      add_list<JMK::list<_T>>(out, "jmk", sizeof(_T), n);
+      add_list<std::list<_T>>(out, "std", sizeof(_T), n);
+      add_adapter<JMK::stack<_T, 0>, _T>(out, "stack", "jmk", n);
+      add_adapter<JMK::stack<_T, JMK::segmented_extent>, _T>(out, "stack", "jmk_segmented", n);
+      add_adapter<std::stack<_T, std::vector<_T>>, _T>(out, "stack", "std_vector", n);
+      add_adapter<std::stack<_T>, _T>(out, "stack", "std_deque", n);
+      add_adapter<JMK::queue<_T, 0>, _T>(out, "queue", "jmk", n);
+      add_adapter<JMK::queue<_T, JMK::segmented_extent>, _T>(out, "queue", "jmk_segmented", n);
+      add_adapter<std::queue<_T>, _T>(out, "queue", "std_deque", n);
+    }
+    add_array<JMK::array<_T, 64>, _T>(out, "jmk", 64);
+    add_array<std::array<_T, 64>, _T>(out, "std", 64);
+    add_array<JMK::array<_T, 16384>, _T>(out, "jmk", 16384);
+    add_array<std::array<_T, 16384>, _T>(out, "std", 16384);
+  }
+
+}
+
+int main(int argc, char** argv) {
+  JMK::bench::options opts;
+  if (!JMK::bench::parse_options(argc, argv, opts)) {
+    return 2;
+  }
+  std::vector<benchmark> benchmarks;
+  add_element<uint32_t>(benchmarks);
+  add_element<payload<64>>(benchmarks);
+  JMK::bench::run_all(benchmarks, opts);
+  return 0;
+}
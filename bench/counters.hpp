@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace JMK::bench {
+
+  // Hardware events read around every timed region when the kernel allows it
+  enum class counter : size_t {
+    cycles,
+    instructions,
+    cache_misses,
+    branch_misses,
+  };
+
+  inline constexpr size_t counter_count = 4;
+
+  inline constexpr std::array<const char*, counter_count> counter_names = {
+    "cycles", "instructions", "cache_misses", "branch_misses",
+  };
+
+  // Event totals for one or more timed regions. An event the kernel would not
+  // open stays unavailable rather than reading as zero.
+  struct counter_values {
+    std::array<double, counter_count> values{};
+    std::array<bool, counter_count> available{};
+
+    [[nodiscard]] bool has(counter c) const noexcept { return available[static_cast<size_t>(c)]; }
+    [[nodiscard]] double operator[](counter c) const noexcept { return values[static_cast<size_t>(c)]; }
+
+    counter_values& operator+=(const counter_values& other) noexcept {
+      for (size_t i = 0; i < counter_count; ++i) {
+        values[i] += other.values[i];
+        available[i] = available[i] || other.available[i];
+      }
+      return *this;
+    }
+  };
+
+  // The user-space counts of this thread, read through perf_event_open as one
+  // group so all events cover the same instructions. Inside containers, VMs
+  // or with perf_event_paranoid > 2 no event may open; the group then does
+  // nothing and every reading is unavailable.
+  class counter_group {
+  public:
+    counter_group() noexcept {
+#if defined(__linux__)
+      static constexpr std::array<uint64_t, counter_count> configs = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+      };
+      for (size_t i = 0; i < counter_count; ++i) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.disabled = m_leader < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, m_leader, 0);
+        if (fd < 0) {
+          continue;
+        }
+        if (m_leader < 0) {
+          m_leader = static_cast<int>(fd);
+        }
+        m_fds[i] = static_cast<int>(fd);
+        m_slots[m_opened++] = i;
+      }
+#endif
+    }
+
+    counter_group(const counter_group&) = delete;
+    counter_group& operator=(const counter_group&) = delete;
+
+    ~counter_group() {
+#if defined(__linux__)
+      for (int fd : m_fds) {
+        if (fd >= 0) {
+          close(fd);
+        }
+      }
+#endif
+    }
+
+    [[nodiscard]] bool available() const noexcept { return m_opened > 0; }
+
+    void start() noexcept {
+#if defined(__linux__)
+      if (available()) {
+        ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      }
+#endif
+    }
+
+    // Stops counting and returns the counts since start(). When the kernel
+    // had to multiplex the group, counts are scaled up to the whole region.
+    counter_values stop() noexcept {
+      counter_values out;
+#if defined(__linux__)
+      if (!available()) {
+        return out;
+      }
+      ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+      // nr, time_enabled, time_running, then one value per opened event
+      uint64_t data[3 + counter_count] = {};
+      if (read(m_leader, data, sizeof(data)) < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[2] == 0) {
+        return out;
+      }
+      double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+      for (size_t i = 0; i < data[0] && i < m_opened; ++i) {
+        out.values[m_slots[i]] = static_cast<double>(data[3 + i]) * scale;
+        out.available[m_slots[i]] = true;
+      }
+#endif
+      return out;
+    }
+
+  private:
+    std::array<int, counter_count> m_fds = { -1, -1, -1, -1 };
+    std::array<size_t, counter_count> m_slots{};
+    size_t m_opened = 0;
+    int m_leader = -1;
+  };
+
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "counters.hpp"
+
+namespace JMK::bench {
+
+  // Keeps the compiler from discarding a value that is only computed for
+  // the benchmark's sake. Passing an object through keep() before timing
+  // also stops its setup from being moved into, or its timed work out of,
+  // the measured region.
+  template <typename _T>
+  inline void keep(const _T& value) noexcept {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+  }
+
+  // Measures the part of a run between start() and stop(), so benchmarks can
+  // keep their setup out of the numbers. With a counter group it also counts
+  // the hardware events of exactly those regions.
+  class stopwatch {
+  public:
+    stopwatch() noexcept = default;
+    explicit stopwatch(counter_group* counters) noexcept : m_counters(counters) {}
+
+    void start() noexcept {
+      if (m_counters) {
+        m_counters->start();
+      }
+      m_begin = std::chrono::steady_clock::now();
+    }
+
+    void stop() noexcept {
+      m_elapsed += std::chrono::steady_clock::now() - m_begin;
+      if (m_counters) {
+        m_events += m_counters->stop();
+      }
+    }
+
+    [[nodiscard]] double nanoseconds() const noexcept {
+      return std::chrono::duration<double, std::nano>(m_elapsed).count();
+    }
+
+    [[nodiscard]] const counter_values& events() const noexcept { return m_events; }
+
+  private:
+    counter_group* m_counters = nullptr;
+    std::chrono::steady_clock::time_point m_begin;
+    std::chrono::steady_clock::duration m_elapsed{};
+    counter_values m_events;
+  };
+
+  // One benchmark: a run measures itself with the stopwatch and returns how
+  // many operations it timed
+  struct benchmark {
+    std::string suite;
+    std::string operation;
+    std::string implementation;
+    size_t element_size = 0;
+    size_t count = 0;
+    std::function<size_t(stopwatch&)> run;
+  };
+
+  // Per operation times of every run, sorted, and event counts per operation
+  // over all runs together
+  struct result {
+    const benchmark* source = nullptr;
+    std::vector<double> samples;
+    counter_values events;
+
+    [[nodiscard]] size_t runs() const noexcept { return samples.size(); }
+
+    // Nearest rank percentile, p in [0, 100]
+    [[nodiscard]] double percentile(double p) const noexcept {
+      if (samples.empty()) {
+        return 0;
+      }
+      size_t rank = static_cast<size_t>(p / 100 * static_cast<double>(samples.size()) + 0.5);
+      return samples[std::min(rank > 0 ? rank - 1 : 0, samples.size() - 1)];
+    }
+
+    [[nodiscard]] double median() const noexcept { return samples.empty() ? 0 : samples[samples.size() / 2]; }
+    [[nodiscard]] double min() const noexcept { return samples.empty() ? 0 : samples.front(); }
+  };
+
+  struct options {
+    std::string filter;
+    double min_time_ms = 50;
+    size_t min_runs = 10;
+    bool json = false;
+    bool counters = true;
+  };
+
+  // Parses --filter=TEXT, --min-time=MS, --min-runs=N, --json and
+  // --no-counters; returns false on anything else
+  inline bool parse_options(int argc, char** argv, options& out) {
+    for (int i = 1; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      auto value = [&](std::string_view name) -> std::string_view {
+        return arg.substr(name.size());
+      };
+      if (arg.starts_with("--filter=")) {
+        out.filter = value("--filter=");
+      }
+      else if (arg.starts_with("--min-time=")) {
+        out.min_time_ms = std::stod(std::string(value("--min-time=")));
+      }
+      else if (arg.starts_with("--min-runs=")) {
+        out.min_runs = std::stoul(std::string(value("--min-runs=")));
+      }
+      else if (arg == "--json") {
+        out.json = true;
+      }
+      else if (arg == "--no-counters") {
+        out.counters = false;
+      }
+      else {
+        std::fprintf(stderr, "usage: %s [--filter=TEXT] [--min-time=MS] [--min-runs=N] [--json] [--no-counters]\n",
+          argv[0]);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Repeats a benchmark until it has both min_runs runs and min_time of
+  // measured time
+  inline result measure(const benchmark& b, const options& opts, counter_group* counters = nullptr) {
+    result r;
+    r.source = &b;
+    double total_ns = 0;
+    size_t total_ops = 0;
+    while (r.samples.size() < opts.min_runs || total_ns < opts.min_time_ms * 1e6) {
+      stopwatch sw(counters);
+      size_t ops = std::max<size_t>(b.run(sw), 1);
+      total_ns += sw.nanoseconds();
+      total_ops += ops;
+      r.samples.push_back(sw.nanoseconds() / static_cast<double>(ops));
+      r.events += sw.events();
+    }
+    std::sort(r.samples.begin(), r.samples.end());
+    for (double& v : r.events.values) {
+      v /= static_cast<double>(total_ops);
+    }
+    return r;
+  }
+
+  namespace _detail {
+
+    // A counter column, empty (or null in JSON) when the event never opened
+    inline std::string _event(const result& r, size_t i, const char* missing) {
+      if (!r.events.available[i]) {
+        return missing;
+      }
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%.3f", r.events.values[i]);
+      return buffer;
+    }
+
+  }
+
+  // Runs every benchmark whose "suite/operation/implementation" name contains
+  // the filter and prints one CSV row, or one JSON object, per benchmark.
+  // JSON keeps every run's time so two result files can be compared with
+  // bench/compare.
+  inline void run_all(const std::vector<benchmark>& benchmarks, const options& opts) {
+    std::unique_ptr<counter_group> counters;
+    if (opts.counters) {
+      counters = std::make_unique<counter_group>();
+      if (!counters->available()) {
+        std::fprintf(stderr, "hardware counters unavailable, reporting time only\n");
+        counters.reset();
+      }
+    }
+    if (opts.json) {
+      std::printf("[\n");
+    }
+    else {
+      std::printf("suite,operation,implementation,element_size,count,runs,median_ns_per_op,min_ns_per_op,"
+        "p90_ns_per_op,p99_ns_per_op");
+      for (const char* name : counter_names) {
+        std::printf(",%s_per_op", name);
+      }
+      std::printf("\n");
+    }
+    bool first = true;
+    for (const benchmark& b : benchmarks) {
+      std::string name = b.suite + "/" + b.operation + "/" + b.implementation;
+      if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos) {
+        continue;
+      }
+      result r = measure(b, opts, counters.get());
+      if (opts.json) {
+        std::printf("%s  {\"suite\": \"%s\", \"operation\": \"%s\", \"implementation\": \"%s\", "
+          "\"element_size\": %zu, \"count\": %zu, \"runs\": %zu, \"median_ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, "
+          "\"p90_ns_per_op\": %.3f, \"p99_ns_per_op\": %.3f",
+          first ? "" : ",\n", b.suite.c_str(), b.operation.c_str(), b.implementation.c_str(),
+          b.element_size, b.count, r.runs(), r.median(), r.min(), r.percentile(90), r.percentile(99));
+        for (size_t i = 0; i < counter_count; ++i) {
+          std::printf(", \"%s_per_op\": %s", counter_names[i], _detail::_event(r, i, "null").c_str());
+        }
+        std::printf(", \"samples_ns_per_op\": [");
+        for (size_t i = 0; i < r.samples.size(); ++i) {
+          std::printf("%s%.3f", i ? ", " : "", r.samples[i]);
+        }
+        std::printf("]}");
+      }
+      else {
+        std::printf("%s,%s,%s,%zu,%zu,%zu,%.3f,%.3f,%.3f,%.3f", b.suite.c_str(), b.operation.c_str(),
+          b.implementation.c_str(), b.element_size, b.count, r.runs(), r.median(), r.min(),
+          r.percentile(90), r.percentile(99));
+        for (size_t i = 0; i < counter_count; ++i) {
+          std::printf(",%s", _detail::_event(r, i, "").c_str());
+        }
+        std::printf("\n");
+      }
+      std::fflush(stdout);
+      first = false;
+    }
+    if (opts.json) {
+      std::printf("\n]\n");
+    }
+  }
+
+}
@@ -0,0 +1,74 @@
+// Measures how JMK::mpmc_queue scales with the number of producer and
+// consumer threads, against the same ring behind a mutex.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 -DNDEBUG -I.. mpmc_queue.cpp -o mpmc_queue -pthread
+//
+// and run ./mpmc_queue [--filter=mpmc_queue/transfer] [--min-time=MS] [--json].
+// Each row runs count producers and count consumers, for 1, 2, 4, ... up to
+// the number of hardware threads, and reports time per item moved through
+// the queue. Once producers plus consumers outnumber the cores the threads
+// take turns and the rows show oversubscription rather than contention.
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../mpmc_queue.hpp"
+#include "harness.hpp"
+#include "threads.hpp"
+
+namespace {
+
+  using JMK::bench::benchmark;
+  using JMK::bench::keep;
+  using JMK::bench::stopwatch;
+
+  constexpr size_t capacity = 1024;
+  constexpr size_t items_per_run = 1 << 16;
+
+  // Producers are threads [0, pairs), consumers [pairs, 2 * pairs); the
+  // items split evenly, the first threads taking any remainder
+  template <typename _Queue>
+  size_t transfer(stopwatch& sw, size_t pairs) {
+    auto queue = std::make_unique<_Queue>();
+    std::vector<uint64_t> sums(pairs);
+    JMK::bench::run_threads(sw, 2 * pairs, [&](size_t id) {
+      size_t index = id % pairs;
+      size_t share = items_per_run / pairs + (index < items_per_run % pairs);
+      if (id < pairs) {
+        for (uint64_t i = 0; i < share; ++i) {
+          queue->enqueue(i);
+        }
+      }
+      else {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < share; ++i) {
+          sum += queue->dequeue();
+        }
+        sums[index] = sum;
+      }
+    });
+    keep(sums);
+    return items_per_run;
+  }
+
+}
+
+int main(int argc, char** argv) {
+  JMK::bench::options opts;
+  if (!JMK::bench::parse_options(argc, argv, opts)) {
+    return 2;
+  }
+  std::vector<benchmark> benchmarks;
+  for (size_t pairs : JMK::bench::thread_counts()) {
+    benchmarks.push_back({ "mpmc_queue", "transfer", "jmk_mpmc", sizeof(uint64_t), pairs,
+      [pairs](stopwatch& sw) { return transfer<JMK::mpmc_queue<uint64_t, capacity>>(sw, pairs); } });
+    benchmarks.push_back({ "mpmc_queue", "transfer", "mutex", sizeof(uint64_t), pairs,
+      [pairs](stopwatch& sw) { return transfer<JMK::bench::locked_queue<uint64_t, capacity>>(sw, pairs); } });
+  }
+  JMK::bench::run_all(benchmarks, opts);
+  return 0;
+}
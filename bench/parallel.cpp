@@ -0,0 +1,155 @@
+// Measures how the JMK::parallel algorithms scale from 1 worker up to the
+// number of hardware threads, against the serial standard algorithms.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 -DNDEBUG -I.. parallel.cpp -o parallel -pthread
+//
+// and run ./parallel [--filter=parallel/sort] [--min-time=MS] [--json].
+// Every row works on 2^20 64-bit integers; count is the number of worker
+// threads (1 for the serial rows) and times are per element. Each run
+// starts its own scheduler before the clock starts.
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../parallel.hpp"
+#include "../scheduler.hpp"
+#include "../vector.hpp"
+#include "harness.hpp"
+#include "threads.hpp"
+
+namespace {
+
+  using JMK::bench::benchmark;
+  using JMK::bench::keep;
+  using JMK::bench::stopwatch;
+
+  constexpr size_t elements = size_t(1) << 20;
+
+  [[nodiscard]] JMK::vector<uint64_t> random_input() {
+    JMK::vector<uint64_t> out;
+    out.reserve(elements);
+    std::mt19937_64 rng(42);
+    for (size_t i = 0; i < elements; ++i) {
+      out.push_back(rng());
+    }
+    return out;
+  }
+
+  // Enough arithmetic per element that the work, not memory, is what scales
+  [[nodiscard]] inline uint64_t mix(uint64_t x) noexcept {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdu;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53u;
+    return x ^ (x >> 33);
+  }
+
+  void add_threads(std::vector<benchmark>& out, size_t threads) {
+    auto add = [&](const char* op, std::function<size_t(stopwatch&)> run) {
+      out.push_back({ "parallel", op, "jmk", sizeof(uint64_t), threads, std::move(run) });
+    };
+    add("transform", [threads](stopwatch& sw) {
+      JMK::scheduler pool(threads);
+      auto in = random_input();
+      JMK::vector<uint64_t> result;
+      result.resize(in.size());
+      sw.start();
+      JMK::parallel::transform(pool, in, result, mix);
+      sw.stop();
+      keep(result);
+      return elements;
+    });
+    add("reduce", [threads](stopwatch& sw) {
+      JMK::scheduler pool(threads);
+      auto in = random_input();
+      sw.start();
+      uint64_t sum = JMK::parallel::reduce(pool, in, uint64_t(0));
+      sw.stop();
+      keep(sum);
+      return elements;
+    });
+    add("inclusive_scan", [threads](stopwatch& sw) {
+      JMK::scheduler pool(threads);
+      auto in = random_input();
+      JMK::vector<uint64_t> result;
+      result.resize(in.size());
+      sw.start();
+      JMK::parallel::inclusive_scan(pool, in, result);
+      sw.stop();
+      keep(result);
+      return elements;
+    });
+    add("sort", [threads](stopwatch& sw) {
+      JMK::scheduler pool(threads);
+      auto data = random_input();
+      sw.start();
+      JMK::parallel::sort(pool, data);
+      sw.stop();
+      keep(data);
+      return elements;
+    });
+  }
+
+  void add_serial(std::vector<benchmark>& out) {
+    auto add = [&](const char* op, std::function<size_t(stopwatch&)> run) {
+      out.push_back({ "parallel", op, "serial", sizeof(uint64_t), 1, std::move(run) });
+    };
+    add("transform", [](stopwatch& sw) {
+      auto in = random_input();
+      JMK::vector<uint64_t> result;
+      result.resize(in.size());
+      sw.start();
+      std::transform(in.data(), in.data() + in.size(), result.data(), mix);
+      sw.stop();
+      keep(result);
+      return elements;
+    });
+    add("reduce", [](stopwatch& sw) {
+      auto in = random_input();
+      sw.start();
+      uint64_t sum = std::reduce(in.data(), in.data() + in.size(), uint64_t(0));
+      sw.stop();
+      keep(sum);
+      return elements;
+    });
+    add("inclusive_scan", [](stopwatch& sw) {
+      auto in = random_input();
+      JMK::vector<uint64_t> result;
+      result.resize(in.size());
+      sw.start();
+      std::inclusive_scan(in.data(), in.data() + in.size(), result.data());
+      sw.stop();
+      keep(result);
+      return elements;
+    });
+    add("sort", [](stopwatch& sw) {
+      auto data = random_input();
+      sw.start();
+      std::sort(data.data(), data.data() + data.size());
+      sw.stop();
+      keep(data);
+      return elements;
+    });
+  }
+
+}
+
+int main(int argc, char** argv) {
+  JMK::bench::options opts;
+  if (!JMK::bench::parse_options(argc, argv, opts)) {
+    return 2;
+  }
+  std::vector<benchmark> benchmarks;
+  add_serial(benchmarks);
+  for (size_t threads : JMK::bench::thread_counts()) {
+    add_threads(benchmarks, threads);
+  }
+  JMK::bench::run_all(benchmarks, opts);
+  return 0;
+}
@@ -0,0 +1,114 @@
+// Measures what JMK::reclamation_domain costs readers and writers in each
+// mode, against plain loads and immediate deletes that no lock-free
+// container could actually get away with.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 -DNDEBUG -I.. reclamation.cpp -o reclamation -pthread
+//
+// and run ./reclamation [--filter=reclamation/read] [--min-time=MS] [--json].
+// "read" enters a guard, protects one shared pointer and reads through it,
+// on 1, 2, 4, ... up to all hardware threads at once (count is the number of
+// threads). "retire" swaps in a new node and retires the old one on a single
+// thread, including its share of the batched scans (count is the retire
+// threshold).
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "../reclamation.hpp"
+#include "harness.hpp"
+#include "threads.hpp"
+
+namespace {
+
+  using JMK::bench::benchmark;
+  using JMK::bench::keep;
+  using JMK::bench::stopwatch;
+
+  constexpr size_t reads_per_thread = 1 << 16;
+  constexpr size_t retires_per_run = 1 << 14;
+
+  struct node {
+    uint64_t m_value;
+  };
+
+  enum class scheme {
+    none,
+    epoch,
+    hazard_pointers
+  };
+
+  [[nodiscard]] JMK::reclamation_mode mode_of(scheme s) noexcept {
+    return s == scheme::hazard_pointers ? JMK::reclamation_mode::hazard_pointers : JMK::reclamation_mode::epoch;
+  }
+
+  size_t read(stopwatch& sw, scheme s, size_t threads) {
+    JMK::reclamation_domain domain(mode_of(s));
+    node shared_node{ 42 };
+    std::atomic<node*> shared = &shared_node;
+    JMK::bench::run_threads(sw, threads, [&](size_t) {
+      uint64_t sum = 0;
+      for (size_t i = 0; i < reads_per_thread; ++i) {
+        if (s == scheme::none) {
+          sum += shared.load(std::memory_order_acquire)->m_value;
+        }
+        else {
+          JMK::reclamation_domain::guard g(domain);
+          sum += g.protect(shared)->m_value;
+        }
+      }
+      keep(sum);
+    });
+    return reads_per_thread * threads;
+  }
+
+  size_t retire(stopwatch& sw, scheme s, size_t threshold) {
+    JMK::reclamation_domain domain(mode_of(s), threshold);
+    std::atomic<node*> shared = new node{ 0 };
+    sw.start();
+    for (uint64_t i = 0; i < retires_per_run; ++i) {
+      node* old = shared.exchange(new node{ i }, std::memory_order_acq_rel);
+      if (s == scheme::none) {
+        delete old;
+      }
+      else {
+        domain.retire(old);
+      }
+    }
+    sw.stop();
+    delete shared.load();
+    return retires_per_run;
+  }
+
+}
+
+int main(int argc, char** argv) {
+  JMK::bench::options opts;
+  if (!JMK::bench::parse_options(argc, argv, opts)) {
+    return 2;
+  }
+  const std::pair<scheme, const char*> schemes[] = {
+    { scheme::none, "unprotected" },
+    { scheme::epoch, "epoch" },
+    { scheme::hazard_pointers, "hazard_pointers" },
+  };
+  std::vector<benchmark> benchmarks;
+  for (size_t threads : JMK::bench::thread_counts()) {
+    for (const auto& [s, name] : schemes) {
+      benchmarks.push_back({ "reclamation", "read", name, sizeof(node), threads,
+        [s, threads](stopwatch& sw) { return read(sw, s, threads); } });
+    }
+  }
+  for (size_t threshold : { size_t(16), JMK::reclamation_domain::default_retire_threshold, size_t(1024) }) {
+    for (const auto& [s, name] : schemes) {
+      benchmarks.push_back({ "reclamation", "retire", name, sizeof(node), threshold,
+        [s, threshold](stopwatch& sw) { return retire(sw, s, threshold); } });
+    }
+  }
+  JMK::bench::run_all(benchmarks, opts);
+  return 0;
+}
@@ -0,0 +1,183 @@
+// Compares JMK::scheduler against a thread pool that shares one mutex
+// protected task queue, from 1 worker up to the number of hardware threads.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 -DNDEBUG -I.. scheduler.cpp -o scheduler -pthread
+//
+// and run ./scheduler [--filter=scheduler/spawn_tree] [--min-time=MS] [--json].
+// "submit" pushes independent tasks from outside the pool, so both sides go
+// through a shared queue. "spawn_tree" has every task spawn two children
+// down to a fixed depth, the fork/join shape the per-worker deques are for.
+// Count is the number of worker threads; times are per task.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../scheduler.hpp"
+#include "harness.hpp"
+#include "threads.hpp"
+
+namespace {
+
+  using JMK::bench::benchmark;
+  using JMK::bench::keep;
+  using JMK::bench::stopwatch;
+
+  constexpr size_t submitted_tasks = 1 << 14;
+  constexpr size_t tree_depth = 14;
+  constexpr size_t tree_tasks = (size_t(1) << (tree_depth + 1)) - 1;
+
+  // The baseline: workers take std::function tasks from one deque under one
+  // mutex and sleep on a condition variable when it runs dry
+  class locked_pool {
+  public:
+    explicit locked_pool(size_t thread_count) {
+      for (size_t i = 0; i < thread_count; ++i) {
+        m_threads.emplace_back([this] { _worker_loop(); });
+      }
+    }
+
+    locked_pool(const locked_pool&) = delete;
+    locked_pool& operator=(const locked_pool&) = delete;
+
+    ~locked_pool() {
+      {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+      }
+      m_ready.notify_all();
+      for (std::thread& thread : m_threads) {
+        thread.join();
+      }
+    }
+
+    template <typename _Fn>
+    void submit(_Fn&& fn) {
+      {
+        std::lock_guard lock(m_mutex);
+        m_tasks.emplace_back(std::forward<_Fn>(fn));
+      }
+      m_ready.notify_one();
+    }
+
+    // Helps with queued tasks until counter drops to zero, as
+    // scheduler::wait_for does
+    void wait_for(const std::atomic<size_t>& counter) {
+      while (counter.load(std::memory_order_acquire) != 0) {
+        std::function<void()> task;
+        {
+          std::lock_guard lock(m_mutex);
+          if (!m_tasks.empty()) {
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+          }
+        }
+        if (task) {
+          task();
+        }
+        else {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+  private:
+    void _worker_loop() {
+      for (;;) {
+        std::function<void()> task;
+        {
+          std::unique_lock lock(m_mutex);
+          m_ready.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+          if (m_tasks.empty()) {
+            return;
+          }
+          task = std::move(m_tasks.front());
+          m_tasks.pop_front();
+        }
+        task();
+      }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stop = false;
+    std::vector<std::thread> m_threads;
+  };
+
+  // A little arithmetic per task so the queues are not the only work
+  inline void leaf_work(size_t seed) {
+    uint64_t x = seed;
+    for (int i = 0; i < 64; ++i) {
+      x = x * 6364136223846793005u + 1442695040888963407u;
+    }
+    keep(x);
+  }
+
+  template <typename _Pool>
+  size_t submit(stopwatch& sw, size_t threads) {
+    _Pool pool(threads);
+    std::atomic<size_t> pending = submitted_tasks;
+    sw.start();
+    for (size_t i = 0; i < submitted_tasks; ++i) {
+      pool.submit([&pending, i] {
+        leaf_work(i);
+        pending.fetch_sub(1, std::memory_order_release);
+      });
+    }
+    pool.wait_for(pending);
+    sw.stop();
+    return submitted_tasks;
+  }
+
+  template <typename _Pool>
+  void spawn_node(_Pool& pool, std::atomic<size_t>& pending, size_t depth) {
+    leaf_work(depth);
+    if (depth != 0) {
+      pending.fetch_add(2, std::memory_order_relaxed);
+      for (int child = 0; child < 2; ++child) {
+        pool.submit([&pool, &pending, depth] { spawn_node(pool, pending, depth - 1); });
+      }
+    }
+    pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  template <typename _Pool>
+  size_t spawn_tree(stopwatch& sw, size_t threads) {
+    _Pool pool(threads);
+    std::atomic<size_t> pending = 1;
+    sw.start();
+    pool.submit([&pool, &pending] { spawn_node(pool, pending, tree_depth); });
+    pool.wait_for(pending);
+    sw.stop();
+    return tree_tasks;
+  }
+
+}
+
+int main(int argc, char** argv) {
+  JMK::bench::options opts;
+  if (!JMK::bench::parse_options(argc, argv, opts)) {
+    return 2;
+  }
+  std::vector<benchmark> benchmarks;
+  for (size_t threads : JMK::bench::thread_counts()) {
+    auto add = [&](const char* op, const char* impl, size_t (*run)(stopwatch&, size_t)) {
+      benchmarks.push_back({ "scheduler", op, impl, 0, threads,
+        [run, threads](stopwatch& sw) { return run(sw, threads); } });
+    };
+    add("submit", "jmk", submit<JMK::scheduler>);
+    add("submit", "mutex", submit<locked_pool>);
+    add("spawn_tree", "jmk", spawn_tree<JMK::scheduler>);
+    add("spawn_tree", "mutex", spawn_tree<locked_pool>);
+  }
+  JMK::bench::run_all(benchmarks, opts);
+  return 0;
+}
@@ -0,0 +1,118 @@
+// Compares JMK::small_vector against JMK::vector at the small sizes it is
+// meant for: a short-lived vector filled with a handful of elements, then
+// read, copied and dropped, the way per-message vectors are used.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 -DNDEBUG -I.. small_vector.cpp -o small_vector
+//
+// and run ./small_vector [--filter=small_vector/build] [--min-time=MS] [--json].
+// Sizes up to the inline capacity of 16 never touch the allocator; 32 shows
+// the cost once small_vector has spilled to the heap.
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../small_vector.hpp"
+#include "../vector.hpp"
+#include "harness.hpp"
+
+namespace {
+
+  using JMK::bench::benchmark;
+  using JMK::bench::keep;
+  using JMK::bench::stopwatch;
+
+  constexpr size_t inline_capacity = 16;
+
+  // Vectors built and dropped per run, so one run outlasts the clock's
+  // resolution even at size 1
+  constexpr size_t vectors_per_run = 1000;
+
+  template <typename _Vec>
+  void add_vector(std::vector<benchmark>& out, const char* impl, size_t n) {
+    using value_type = typename _Vec::iterator::value_type;
+    auto add = [&](const char* op, std::function<size_t(stopwatch&)> run) {
+      out.push_back({ "small_vector", op, impl, sizeof(value_type), n, std::move(run) });
+    };
+    add("build", [n](stopwatch& sw) {
+      sw.start();
+      for (size_t k = 0; k < vectors_per_run; ++k) {
+        _Vec v;
+        for (size_t i = 0; i < n; ++i) {
+          v.push_back(static_cast<value_type>(i));
+        }
+        keep(v);
+      }
+      sw.stop();
+      return vectors_per_run;
+    });
+    add("build_iterate", [n](stopwatch& sw) {
+      uint64_t sum = 0;
+      sw.start();
+      for (size_t k = 0; k < vectors_per_run; ++k) {
+        _Vec v;
+        for (size_t i = 0; i < n; ++i) {
+          v.push_back(static_cast<value_type>(i));
+        }
+        for (const auto& item : v) {
+          sum += static_cast<uint64_t>(item);
+        }
+      }
+      sw.stop();
+      keep(sum);
+      return vectors_per_run;
+    });
+    add("copy", [n](stopwatch& sw) {
+      _Vec source;
+      for (size_t i = 0; i < n; ++i) {
+        source.push_back(static_cast<value_type>(i));
+      }
+      keep(source);
+      sw.start();
+      for (size_t k = 0; k < vectors_per_run; ++k) {
+        _Vec copy(source);
+        keep(copy);
+      }
+      sw.stop();
+      return vectors_per_run;
+    });
+    add("move", [n](stopwatch& sw) {
+      _Vec source;
+      for (size_t i = 0; i < n; ++i) {
+        source.push_back(static_cast<value_type>(i));
+      }
+      keep(source);
+      sw.start();
+      for (size_t k = 0; k < vectors_per_run; ++k) {
+        _Vec moved(std::move(source));
+        keep(moved);
+        source = std::move(moved);
+      }
+      sw.stop();
+      return vectors_per_run;
+    });
+  }
+
+  template <typename _T>
+  void add_element(std::vector<benchmark>& out) {
+    for (size_t n : { size_t(1), size_t(4), size_t(8), size_t(16), size_t(32) }) {
+      add_vector<JMK::small_vector<_T, inline_capacity>>(out, "jmk_small", n);
+      add_vector<JMK::vector<_T>>(out, "jmk", n);
+    }
+  }
+
+}
+
+int main(int argc, char** argv) {
+  JMK::bench::options opts;
+  if (!JMK::bench::parse_options(argc, argv, opts)) {
+    return 2;
+  }
+  std::vector<benchmark> benchmarks;
+  add_element<uint32_t>(benchmarks);
+  add_element<uint64_t>(benchmarks);
+  JMK::bench::run_all(benchmarks, opts);
+  return 0;
+}
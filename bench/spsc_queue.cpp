@@ -0,0 +1,95 @@
+// Compares JMK::spsc_queue against the same ring behind a mutex, with one
+// producer and one consumer thread.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O2 -DNDEBUG -I.. spsc_queue.cpp -o spsc_queue -pthread
+//
+// and run ./spsc_queue [--filter=spsc_queue/latency] [--min-time=MS] [--json].
+// "throughput" streams items from the producer to the consumer and reports
+// time per item. "latency" bounces one item between the two threads through
+// a pair of queues and reports time per round trip. Both need two free cores
+// to mean anything; on fewer, the numbers are dominated by the scheduler.
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../spsc_queue.hpp"
+#include "harness.hpp"
+#include "threads.hpp"
+
+namespace {
+
+  using JMK::bench::benchmark;
+  using JMK::bench::keep;
+  using JMK::bench::stopwatch;
+
+  constexpr size_t items_per_run = 1 << 16;
+  constexpr size_t round_trips_per_run = 1 << 12;
+
+  template <typename _Queue>
+  size_t throughput(stopwatch& sw) {
+    auto queue = std::make_unique<_Queue>();
+    uint64_t sum = 0;
+    JMK::bench::run_threads(sw, 2, [&](size_t id) {
+      if (id == 0) {
+        for (uint64_t i = 0; i < items_per_run; ++i) {
+          queue->enqueue(i);
+        }
+      }
+      else {
+        for (size_t i = 0; i < items_per_run; ++i) {
+          sum += queue->dequeue();
+        }
+      }
+    });
+    keep(sum);
+    return items_per_run;
+  }
+
+  template <typename _Queue>
+  size_t latency(stopwatch& sw) {
+    auto ping = std::make_unique<_Queue>();
+    auto pong = std::make_unique<_Queue>();
+    JMK::bench::run_threads(sw, 2, [&](size_t id) {
+      for (uint64_t i = 0; i < round_trips_per_run; ++i) {
+        if (id == 0) {
+          ping->enqueue(i);
+          keep(pong->dequeue());
+        }
+        else {
+          pong->enqueue(ping->dequeue());
+        }
+      }
+    });
+    return round_trips_per_run;
+  }
+
+  template <size_t _N>
+  void add_capacity(std::vector<benchmark>& out) {
+    using spsc = JMK::spsc_queue<uint64_t, _N>;
+    using locked = JMK::bench::locked_queue<uint64_t, _N>;
+    auto add = [&](const char* op, const char* impl, std::function<size_t(stopwatch&)> run) {
+      out.push_back({ "spsc_queue", op, impl, sizeof(uint64_t), _N, std::move(run) });
+    };
+    add("throughput", "jmk_spsc", throughput<spsc>);
+    add("throughput", "mutex", throughput<locked>);
+    add("latency", "jmk_spsc", latency<spsc>);
+    add("latency", "mutex", latency<locked>);
+  }
+
+}
+
+int main(int argc, char** argv) {
+  JMK::bench::options opts;
+  if (!JMK::bench::parse_options(argc, argv, opts)) {
+    return 2;
+  }
+  std::vector<benchmark> benchmarks;
+  add_capacity<64>(benchmarks);
+  add_capacity<1024>(benchmarks);
+  JMK::bench::run_all(benchmarks, opts);
+  return 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../queue.hpp"
+#include "harness.hpp"
+
+namespace JMK::bench {
+
+  // The baseline the concurrent queues are measured against: the plain ring
+  // of JMK::queue behind one mutex, with the same try/blocking interface
+  template <typename _T, size_t _N>
+  class locked_queue {
+  public:
+    bool try_enqueue(_T item) {
+      std::lock_guard lock(m_mutex);
+      if (m_queue.size() == _N) {
+        return false;
+      }
+      m_queue.enqueue(std::move(item));
+      return true;
+    }
+
+    bool try_dequeue(_T& out) {
+      std::lock_guard lock(m_mutex);
+      if (m_queue.empty()) {
+        return false;
+      }
+      out = m_queue.dequeue();
+      return true;
+    }
+
+    void enqueue(_T item) {
+      while (!try_enqueue(item)) {
+        std::this_thread::yield();
+      }
+    }
+
+    _T dequeue() {
+      _T out;
+      while (!try_dequeue(out)) {
+        std::this_thread::yield();
+      }
+      return out;
+    }
+
+  private:
+    std::mutex m_mutex;
+    JMK::queue<_T, _N> m_queue;
+  };
+
+  // 1, 2, 4, ... up to and including the number of hardware threads
+  [[nodiscard]] inline std::vector<size_t> thread_counts() {
+    size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> out;
+    for (size_t n = 1; n < cores; n *= 2) {
+      out.push_back(n);
+    }
+    out.push_back(cores);
+    return out;
+  }
+
+  // Runs fn(0) .. fn(threads - 1) on their own threads and times them from
+  // the moment all have started until the last one returns, so thread
+  // creation stays out of the numbers
+  template <typename _Fn>
+  void run_threads(stopwatch& sw, size_t threads, _Fn&& fn) {
+    std::atomic<size_t> ready = 0;
+    std::atomic<bool> go = false;
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+      pool.emplace_back([&, i] {
+        ready.fetch_add(1, std::memory_order_release);
+        while (!go.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+        fn(i);
+      });
+    }
+    while (ready.load(std::memory_order_acquire) != threads) {
+      std::this_thread::yield();
+    }
+    sw.start();
+    go.store(true, std::memory_order_release);
+    for (auto& t : pool) {
+      t.join();
+    }
+    sw.stop();
+  }
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "simd.hpp"
+#include "traits.hpp"
+
+namespace JMK {
+
+  // Element-wise equality of two contiguous ranges. Bitwise comparable types
+  // go through memcmp and other arithmetic types through simd::mismatch.
+  template <typename _T>
+  [[nodiscard]] constexpr bool equal_ranges(const _T* lhs, size_t lhs_size, const _T* rhs, size_t rhs_size) {
+    if (lhs_size != rhs_size) {
+      return false;
+    }
+    if (!std::is_constant_evaluated()) {
+      if constexpr (JMK::is_bitwise_comparable_v<_T>) {
+        return lhs_size == 0 || std::memcmp(lhs, rhs, lhs_size * sizeof(_T)) == 0;
+      }
+      else if constexpr (JMK::simd::arithmetic<_T>) {
+        return JMK::simd::mismatch(lhs, rhs, lhs_size) == lhs_size;
+      }
+    }
+    for (size_t i = 0; i < lhs_size; ++i) {
+      if (!(lhs[i] == rhs[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Lexicographic three-way comparison of two contiguous ranges
+  template <std::three_way_comparable _T>
+  [[nodiscard]] constexpr std::compare_three_way_result_t<_T> compare_ranges(const _T* lhs, size_t lhs_size,
+    const _T* rhs, size_t rhs_size) {
+    size_t common = std::min(lhs_size, rhs_size);
+    size_t i = 0;
+    if (!std::is_constant_evaluated()) {
+      // memcmp orders bytes as unsigned char, which only matches for these
+      if constexpr (sizeof(_T) == 1 && std::is_unsigned_v<_T>) {
+        int order = common == 0 ? 0 : std::memcmp(lhs, rhs, common);
+        if (order != 0) {
+          return order <=> 0;
+        }
+        i = common;
+      }
+      else if constexpr (JMK::simd::arithmetic<_T>) {
+        // Skips the equal prefix; the loop below orders the first difference
+        i = JMK::simd::mismatch(lhs, rhs, common);
+      }
+    }
+    for (; i < common; ++i) {
+      if (auto order = lhs[i] <=> rhs[i]; order != 0) {
+        return order;
+      }
+    }
+    return lhs_size <=> rhs_size;
+  }
+
+}
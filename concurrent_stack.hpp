@@ -0,0 +1,297 @@
+#pragma once
+
+#include <cassert>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "backoff.hpp"
+#include "traits.hpp"
+
+namespace JMK {
+
+  // Lock-free LIFO (Treiber stack). The head is a pointer packed with a
+  // generation tag that every successful CAS bumps, which makes ABA need a
+  // whole wrap of the tag while a thread sits between its load and its CAS
+  // (see _tagged_head).
+  // Popped nodes are kept on an internal free list instead of being freed,
+  // so a thread that lost a race can still safely read a stale node's link.
+  // Under contention pushes and pops try to cancel each other out through a
+  // small elimination array instead of fighting over the head.
+  template <typename _T>
+  class concurrent_stack {
+    // Aligned to at least 16 bytes, what malloc hands out on 64-bit targets
+    // anyway, so the low four bits of every node address are free for the tag
+    struct alignas(16) _node {
+      std::atomic<_node*> m_next = nullptr;
+      alignas(_T) std::byte m_storage[sizeof(_T)];
+
+      [[nodiscard]] _T* item() noexcept { return std::launder(reinterpret_cast<_T*>(m_storage)); }
+    };
+
+    // Node address in the low bits, generation tag in the high bits, so one
+    // plain 64-bit CAS covers both. A double-width CAS was the alternative;
+    // it needs cmpxchg16b and libatomic, so the tag is widened instead by
+    // dropping the address bits that node alignment keeps zero. On 64-bit
+    // targets addresses fit in 48 bits, which is what x86-64 and AArch64
+    // hand to user space unless asked for more (with 5-level paging, Linux
+    // only maps above 2^47 on an explicit hint); pack() asserts it. With
+    // 16-byte nodes that leaves 44 bits of address and a 20-bit tag, which
+    // wraps after 1,048,576 successful CASes. ABA stays unlikely rather than
+    // impossible: a thread stalled between its load and its CAS for exactly
+    // a multiple of that, with the same node back on top, would still
+    // succeed. 32-bit targets get a 36-bit tag.
+    class _tagged_head {
+      static constexpr unsigned _align_bits = std::countr_zero(alignof(_node));
+      static constexpr unsigned _addr_bits = sizeof(void*) == 8 ? 48 : 32;
+      static constexpr unsigned _ptr_bits = _addr_bits - _align_bits;
+      static constexpr uint64_t _ptr_mask = (uint64_t(1) << _ptr_bits) - 1;
+
+    public:
+      [[nodiscard]] static uint64_t pack(_node* ptr, uint64_t tag) noexcept {
+        uint64_t address = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+        assert((address >> _addr_bits) == 0 && "JMK::concurrent_stack node address does not fit the tagged head");
+        return (address >> _align_bits) | (tag << _ptr_bits);
+      }
+
+      [[nodiscard]] static _node* ptr(uint64_t word) noexcept {
+        return reinterpret_cast<_node*>(static_cast<uintptr_t>((word & _ptr_mask) << _align_bits));
+      }
+
+      [[nodiscard]] static uint64_t tag(uint64_t word) noexcept { return word >> _ptr_bits; }
+
+      // Both lists run the same push and pop over their own tagged head
+      void push_chain(_node* first, _node* last) noexcept {
+        uint64_t head = m_word.load(std::memory_order_relaxed);
+        do {
+          last->m_next.store(ptr(head), std::memory_order_relaxed);
+        } while (!m_word.compare_exchange_weak(head, pack(first, tag(head) + 1),
+          std::memory_order_release, std::memory_order_relaxed));
+      }
+
+      bool try_push(_node* n) noexcept {
+        uint64_t head = m_word.load(std::memory_order_relaxed);
+        n->m_next.store(ptr(head), std::memory_order_relaxed);
+        return m_word.compare_exchange_strong(head, pack(n, tag(head) + 1),
+          std::memory_order_release, std::memory_order_relaxed);
+      }
+
+      // Returns nullptr if empty; sets contended if the CAS lost a race
+      _node* try_pop(bool& contended) noexcept {
+        uint64_t head = m_word.load(std::memory_order_acquire);
+        _node* top = ptr(head);
+        if (top == nullptr) {
+          contended = false;
+          return nullptr;
+        }
+        _node* next = top->m_next.load(std::memory_order_relaxed);
+        if (m_word.compare_exchange_strong(head, pack(next, tag(head) + 1),
+          std::memory_order_acquire, std::memory_order_relaxed)) {
+          contended = false;
+          return top;
+        }
+        contended = true;
+        return nullptr;
+      }
+
+      _node* pop() noexcept {
+        JMK::backoff contention;
+        for (;;) {
+          bool contended;
+          _node* top = try_pop(contended);
+          if (!contended) {
+            return top;
+          }
+          contention.spin();
+        }
+      }
+
+      _node* detach() noexcept {
+        uint64_t head = m_word.load(std::memory_order_relaxed);
+        while (!m_word.compare_exchange_weak(head, pack(nullptr, tag(head) + 1),
+          std::memory_order_acquire, std::memory_order_relaxed)) {
+        }
+        return ptr(head);
+      }
+
+      [[nodiscard]] bool empty() const noexcept {
+        return ptr(m_word.load(std::memory_order_relaxed)) == nullptr;
+      }
+
+    private:
+      std::atomic<uint64_t> m_word = 0;
+    };
+
+  public:
+    static constexpr size_t elimination_slots = 8;
+    static constexpr uint32_t elimination_spins = 128;
+
+    concurrent_stack() = default;
+
+    concurrent_stack(const concurrent_stack&) = delete;
+    concurrent_stack& operator=(const concurrent_stack&) = delete;
+
+    ~concurrent_stack() {
+      _node* n = m_head.detach();
+      while (n) {
+        _node* next = n->m_next.load(std::memory_order_relaxed);
+        n->item()->~_T();
+        delete n;
+        n = next;
+      }
+      n = m_free.detach();
+      while (n) {
+        _node* next = n->m_next.load(std::memory_order_relaxed);
+        delete n;
+        n = next;
+      }
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return m_head.empty(); }
+
+    template <typename ... _Args>
+    void emplace(_Args&& ... args) {
+      _node* n = _acquire_node();
+      ::new(static_cast<void*>(n->m_storage)) _T(std::forward<_Args>(args)...);
+      _push_node(n);
+    }
+
+    void push(const _T& item) {
+      emplace(item);
+    }
+
+    void push(_T&& item) {
+      emplace(std::move(item));
+    }
+
+    bool try_pop(_T& out) noexcept(std::is_nothrow_move_assignable_v<_T>) {
+      _node* n = _pop_node();
+      if (n == nullptr) {
+        return false;
+      }
+      out = std::move(*n->item());
+      _release_node(n);
+      return true;
+    }
+
+    // Detaches the whole chain with a single CAS, then moves every element
+    // into out, most recently pushed first. Returns how many were popped.
+    template <typename _OutIt>
+    size_t pop_all(_OutIt out) {
+      _node* first = m_head.detach();
+      if (first == nullptr) {
+        return 0;
+      }
+      size_t count = 0;
+      _node* last = first;
+      for (_node* n = first; n; n = n->m_next.load(std::memory_order_relaxed)) {
+        *out = std::move(*n->item());
+        ++out;
+        n->item()->~_T();
+        last = n;
+        ++count;
+      }
+      m_free.push_chain(first, last);
+      return count;
+    }
+
+  private:
+    _node* _acquire_node() {
+      _node* n = m_free.pop();
+      return n ? n : new _node;
+    }
+
+    void _release_node(_node* n) noexcept {
+      n->item()->~_T();
+      m_free.push_chain(n, n);
+    }
+
+    void _push_node(_node* n) noexcept {
+      JMK::backoff contention;
+      while (!m_head.try_push(n)) {
+        if (_offer(n)) {
+          return;
+        }
+        contention.spin();
+      }
+    }
+
+    _node* _pop_node() noexcept {
+      JMK::backoff contention;
+      for (;;) {
+        bool contended;
+        _node* n = m_head.try_pop(contended);
+        if (!contended) {
+          return n;
+        }
+        if ((n = _take_offer()) != nullptr) {
+          return n;
+        }
+        contention.spin();
+      }
+    }
+
+    // A losing pusher parks its node in a slot for a while. A popper that
+    // grabs it swaps in the taken marker, and only the pusher ever clears a
+    // slot back to empty, so a slot can never be reused behind its back.
+    bool _offer(_node* n) noexcept {
+      std::atomic<_node*>& slot = m_elimination[_slot_index()].m_node;
+      _node* expected = nullptr;
+      if (!slot.compare_exchange_strong(expected, n, std::memory_order_release, std::memory_order_relaxed)) {
+        return false;
+      }
+      for (uint32_t i = 0; i < elimination_spins; ++i) {
+        if (slot.load(std::memory_order_acquire) == _taken()) {
+          slot.store(nullptr, std::memory_order_relaxed);
+          return true;
+        }
+        JMK::cpu_relax();
+      }
+      expected = n;
+      if (slot.compare_exchange_strong(expected, nullptr, std::memory_order_relaxed)) {
+        return false;
+      }
+      // Taken while withdrawing
+      slot.store(nullptr, std::memory_order_relaxed);
+      return true;
+    }
+
+    _node* _take_offer() noexcept {
+      std::atomic<_node*>& slot = m_elimination[_slot_index()].m_node;
+      _node* n = slot.load(std::memory_order_acquire);
+      if (n == nullptr || n == _taken()) {
+        return nullptr;
+      }
+      if (slot.compare_exchange_strong(n, _taken(), std::memory_order_acquire, std::memory_order_relaxed)) {
+        return n;
+      }
+      return nullptr;
+    }
+
+    [[nodiscard]] static size_t _slot_index() noexcept {
+      static thread_local uint32_t seed = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&seed) >> 4) | 1;
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      return seed % elimination_slots;
+    }
+
+    [[nodiscard]] static _node* _taken() noexcept {
+      static _node marker;
+      return &marker;
+    }
+
+    struct alignas(JMK::cache_line_size) _slot {
+      std::atomic<_node*> m_node = nullptr;
+    };
+
+    alignas(JMK::cache_line_size) _tagged_head m_head;
+    alignas(JMK::cache_line_size) _tagged_head m_free;
+    _slot m_elimination[elimination_slots];
+  };
+
+}
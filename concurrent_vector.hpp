@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cassert>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "traits.hpp"
+
+namespace JMK {
+
+  // Append-only vector that many threads can grow while others read. Elements
+  // live in segments of geometrically increasing size that are never moved,
+  // so indices and references stay valid for the container's lifetime.
+  // Appends claim their slots with a single fetch_add and the segment they
+  // land in is installed with a CAS; reads are two loads and never wait.
+  //
+  // size() counts claimed slots, which can include elements still being
+  // constructed by another thread; ready() tells whether one is published.
+  template <typename _T, typename _Alloc = std::allocator<_T>>
+  class concurrent_vector {
+    struct _slot {
+      alignas(_T) std::byte m_storage[sizeof(_T)];
+      std::atomic<bool> m_ready = false;
+
+      [[nodiscard]] _T* item() noexcept { return std::launder(reinterpret_cast<_T*>(m_storage)); }
+      [[nodiscard]] const _T* item() const noexcept { return std::launder(reinterpret_cast<const _T*>(m_storage)); }
+    };
+
+    using _slot_alloc = typename std::allocator_traits<_Alloc>::template rebind_alloc<_slot>;
+    using _slot_traits = std::allocator_traits<_slot_alloc>;
+
+  public:
+    using allocator_type = _Alloc;
+
+    // Segment k holds first_segment_size << k elements
+    static constexpr size_t first_segment_size = 8;
+
+    concurrent_vector() noexcept(std::is_nothrow_default_constructible_v<_Alloc>) = default;
+    explicit concurrent_vector(const _Alloc& alloc) noexcept : m_alloc(alloc) {}
+
+    concurrent_vector(const concurrent_vector&) = delete;
+    concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+    ~concurrent_vector() {
+      for (size_t k = 0; k < _max_segments; ++k) {
+        _slot* segment = m_segments[k].load(std::memory_order_acquire);
+        if (segment == nullptr) {
+          continue;
+        }
+        size_t count = _segment_size(k);
+        for (size_t i = 0; i < count; ++i) {
+          if (segment[i].m_ready.load(std::memory_order_relaxed)) {
+            segment[i].item()->~_T();
+          }
+        }
+        _free_segment(segment, count);
+      }
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return allocator_type(m_alloc); }
+
+    [[nodiscard]] size_t size() const noexcept { return m_size.load(std::memory_order_acquire); }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    // Slots covered by the segments allocated so far
+    [[nodiscard]] size_t capacity() const noexcept {
+      size_t k = 0;
+      while (k < _max_segments && m_segments[k].load(std::memory_order_relaxed) != nullptr) {
+        ++k;
+      }
+      return _segment_base(k);
+    }
+
+    [[nodiscard]] bool ready(size_t index) const noexcept {
+      const _slot* slot = index < size() ? _find_slot(index) : nullptr;
+      return slot && slot->m_ready.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] _T& at(size_t index) {
+      assert(ready(index));
+      return *_slot_at(index).item();
+    }
+
+    [[nodiscard]] const _T& at(size_t index) const {
+      assert(ready(index));
+      return *_slot_at(index).item();
+    }
+
+    [[nodiscard]] _T& operator[](size_t index) noexcept {
+      return *_slot_at(index).item();
+    }
+
+    [[nodiscard]] const _T& operator[](size_t index) const noexcept {
+      return *_slot_at(index).item();
+    }
+
+    // Returns the index of the new element
+    template <typename ... _Args>
+    size_t emplace_back(_Args&& ... args) {
+      size_t index = m_size.fetch_add(1, std::memory_order_acq_rel);
+      _construct(_reserve_slot(index), std::forward<_Args>(args)...);
+      return index;
+    }
+
+    size_t push_back(const _T& value) {
+      return emplace_back(value);
+    }
+
+    size_t push_back(_T&& value) {
+      return emplace_back(std::move(value));
+    }
+
+    // Appends count default constructed elements as one contiguous run of
+    // indices and returns the first
+    size_t grow_by(size_t count) {
+      size_t first = m_size.fetch_add(count, std::memory_order_acq_rel);
+      for (size_t i = first; i < first + count; ++i) {
+        _construct(_reserve_slot(i));
+      }
+      return first;
+    }
+
+    size_t grow_by(size_t count, const _T& value) {
+      size_t first = m_size.fetch_add(count, std::memory_order_acq_rel);
+      for (size_t i = first; i < first + count; ++i) {
+        _construct(_reserve_slot(i), value);
+      }
+      return first;
+    }
+
+    // Calls fn(index, element) for every published element, in index order
+    template <typename _Fn>
+    void for_each(_Fn&& fn) const {
+      size_t count = size();
+      for (size_t i = 0; i < count; ++i) {
+        const _slot* slot = _find_slot(i);
+        if (slot && slot->m_ready.load(std::memory_order_acquire)) {
+          fn(i, *slot->item());
+        }
+      }
+    }
+
+  private:
+    static constexpr size_t _first_shift = std::countr_zero(first_segment_size);
+    static constexpr size_t _max_segments = sizeof(size_t) * 8 - _first_shift;
+
+    static_assert(std::has_single_bit(first_segment_size), "JMK::concurrent_vector segment size must be a power of two");
+
+    [[nodiscard]] static constexpr size_t _segment_of(size_t index) noexcept {
+      return std::bit_width((index >> _first_shift) + 1) - 1;
+    }
+
+    [[nodiscard]] static constexpr size_t _segment_base(size_t segment) noexcept {
+      return ((size_t(1) << segment) - 1) << _first_shift;
+    }
+
+    [[nodiscard]] static constexpr size_t _segment_size(size_t segment) noexcept {
+      return first_segment_size << segment;
+    }
+
+    [[nodiscard]] _slot& _slot_at(size_t index) const noexcept {
+      size_t k = _segment_of(index);
+      return m_segments[k].load(std::memory_order_acquire)[index - _segment_base(k)];
+    }
+
+    // Null while the segment holding a claimed index is still being installed
+    [[nodiscard]] _slot* _find_slot(size_t index) const noexcept {
+      size_t k = _segment_of(index);
+      _slot* segment = m_segments[k].load(std::memory_order_acquire);
+      return segment ? segment + (index - _segment_base(k)) : nullptr;
+    }
+
+    // Makes sure the segment holding index exists and returns its slot
+    _slot& _reserve_slot(size_t index) {
+      size_t k = _segment_of(index);
+      _slot* segment = m_segments[k].load(std::memory_order_acquire);
+      if (segment == nullptr) {
+        size_t count = _segment_size(k);
+        _slot* fresh = _slot_traits::allocate(m_alloc, count);
+        for (size_t i = 0; i < count; ++i) {
+          _slot_traits::construct(m_alloc, fresh + i);
+        }
+        if (m_segments[k].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+          segment = fresh;
+        }
+        else {
+          // Another thread installed it first
+          _free_segment(fresh, count);
+        }
+      }
+      return segment[index - _segment_base(k)];
+    }
+
+    template <typename ... _Args>
+    static void _construct(_slot& slot, _Args&& ... args) {
+      ::new(static_cast<void*>(slot.m_storage)) _T(std::forward<_Args>(args)...);
+      slot.m_ready.store(true, std::memory_order_release);
+    }
+
+    void _free_segment(_slot* segment, size_t count) noexcept {
+      _slot_traits::deallocate(m_alloc, segment, count);
+    }
+
+    [[no_unique_address]] _slot_alloc m_alloc;
+    // Every push_back bumps the size, while the segment table is read by
+    // every access and almost never written, so they get separate lines
+    alignas(JMK::cache_line_size) std::atomic<size_t> m_size = 0;
+    alignas(JMK::cache_line_size) std::atomic<_slot*> m_segments[_max_segments] = {};
+  };
+
+}
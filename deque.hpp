@@ -0,0 +1,417 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "vector.hpp"
+
+namespace JMK {
+
+  // queue and stack extent that selects JMK::deque as backing storage
+  inline constexpr size_t segmented_extent = std::numeric_limits<size_t>::max();
+
+  // Double-ended queue over fixed-size blocks. A map of block pointers keeps
+  // indexing O(1); growing at either end allocates a new block and at most
+  // recentres the map, so elements are never copied or moved once placed and
+  // references to them stay valid until they are erased.
+  template <typename _T, typename _Alloc = std::allocator<_T>>
+  class deque {
+    using _alloc_traits = std::allocator_traits<_Alloc>;
+    using _map_alloc = typename _alloc_traits::template rebind_alloc<_T*>;
+
+  public:
+    using allocator_type = _Alloc;
+
+    // Elements per block, a power of two of roughly a page
+    static constexpr size_t block_size = std::bit_floor(std::max<size_t>(16, 4096 / sizeof(_T)));
+
+    template <typename _V>
+    class basic_iterator {
+      friend class JMK::deque<_T, _Alloc>;
+
+    public:
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type = std::remove_cv_t<_V>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = _V*;
+      using reference = _V&;
+
+      basic_iterator() noexcept = default;
+      basic_iterator(_T* const* map, size_t pos) noexcept : m_map(map), m_pos(pos) {}
+
+      template <typename _W> requires (std::is_const_v<_V> && !std::is_const_v<_W>)
+      basic_iterator(const basic_iterator<_W>& other) noexcept : m_map(other.m_map), m_pos(other.m_pos) {}
+
+      [[nodiscard]] reference operator*() const noexcept {
+        return m_map[m_pos >> _block_shift][m_pos & _block_mask];
+      }
+
+      [[nodiscard]] pointer operator->() const noexcept { return &operator*(); }
+
+      [[nodiscard]] reference operator[](difference_type i) const noexcept { return *(*this + i); }
+
+      basic_iterator& operator++() noexcept {
+        m_pos += 1;
+        return *this;
+      }
+
+      basic_iterator operator++(int) noexcept {
+        basic_iterator copy = *this;
+        m_pos += 1;
+        return copy;
+      }
+
+      basic_iterator& operator--() noexcept {
+        m_pos -= 1;
+        return *this;
+      }
+
+      basic_iterator operator--(int) noexcept {
+        basic_iterator copy = *this;
+        m_pos -= 1;
+        return copy;
+      }
+
+      basic_iterator& operator+=(difference_type i) noexcept {
+        m_pos += i;
+        return *this;
+      }
+
+      basic_iterator& operator-=(difference_type i) noexcept {
+        m_pos -= i;
+        return *this;
+      }
+
+      [[nodiscard]] basic_iterator operator+(difference_type i) const noexcept { return basic_iterator(m_map, m_pos + i); }
+      [[nodiscard]] basic_iterator operator-(difference_type i) const noexcept { return basic_iterator(m_map, m_pos - i); }
+
+      [[nodiscard]] friend basic_iterator operator+(difference_type i, const basic_iterator& it) noexcept { return it + i; }
+
+      [[nodiscard]] difference_type operator-(const basic_iterator& other) const noexcept {
+        return static_cast<difference_type>(m_pos) - static_cast<difference_type>(other.m_pos);
+      }
+
+      [[nodiscard]] bool operator==(const basic_iterator& other) const noexcept { return m_pos == other.m_pos; }
+      [[nodiscard]] std::strong_ordering operator<=>(const basic_iterator& other) const noexcept { return m_pos <=> other.m_pos; }
+
+    private:
+      template <typename _W>
+      friend class basic_iterator;
+
+      _T* const* m_map = nullptr;
+      size_t m_pos = 0;
+    };
+
+    using iterator = basic_iterator<_T>;
+    using const_iterator = basic_iterator<const _T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    deque() noexcept(std::is_nothrow_default_constructible_v<_Alloc>) = default;
+
+    explicit deque(const _Alloc& alloc) noexcept : m_map(_map_alloc(alloc)), m_alloc(alloc) {}
+
+    deque(std::initializer_list<_T> list, const _Alloc& alloc = _Alloc()) : deque(alloc) {
+      for (const _T& item : list) {
+        emplace_back(item);
+      }
+    }
+
+    deque(const deque& other)
+      : deque(_alloc_traits::select_on_container_copy_construction(other.m_alloc)) {
+      for (const _T& item : other) {
+        emplace_back(item);
+      }
+    }
+
+    deque(deque&& other) noexcept
+      : m_map(std::move(other.m_map)), m_start(other.m_start), m_size(other.m_size),
+      m_spare(other.m_spare), m_alloc(std::move(other.m_alloc)) {
+      other.m_start = 0;
+      other.m_size = 0;
+      other.m_spare = nullptr;
+    }
+
+    ~deque() {
+      clear();
+      _release_spare();
+    }
+
+    deque& operator=(const deque& other) {
+      if (this != &other) {
+        clear();
+        if constexpr (_alloc_traits::propagate_on_container_copy_assignment::value) {
+          if (m_alloc != other.m_alloc) {
+            _release_spare();
+          }
+          m_alloc = other.m_alloc;
+        }
+        for (const _T& item : other) {
+          emplace_back(item);
+        }
+      }
+      return *this;
+    }
+
+    deque& operator=(deque&& other) noexcept(_alloc_traits::propagate_on_container_move_assignment::value ||
+      _alloc_traits::is_always_equal::value) {
+      if (this == &other) {
+        return *this;
+      }
+      clear();
+      if constexpr (!_alloc_traits::propagate_on_container_move_assignment::value &&
+        !_alloc_traits::is_always_equal::value) {
+        // Blocks owned by a foreign allocator cannot be adopted, move element-wise
+        if (m_alloc != other.m_alloc) {
+          for (_T& item : other) {
+            emplace_back(std::move(item));
+          }
+          other.clear();
+          return *this;
+        }
+      }
+      _release_spare();
+      if constexpr (_alloc_traits::propagate_on_container_move_assignment::value) {
+        m_alloc = std::move(other.m_alloc);
+      }
+      m_map = std::move(other.m_map);
+      m_start = other.m_start;
+      m_size = other.m_size;
+      m_spare = other.m_spare;
+      other.m_start = 0;
+      other.m_size = 0;
+      other.m_spare = nullptr;
+      return *this;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_alloc; }
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+    [[nodiscard]] size_t max_size() const noexcept { return std::numeric_limits<size_t>::max() / 2; }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] _T& at(size_t index) {
+      assert(index < size());
+      return _element(m_start + index);
+    }
+
+    [[nodiscard]] const _T& at(size_t index) const {
+      assert(index < size());
+      return _element(m_start + index);
+    }
+
+    [[nodiscard]] _T& operator[](size_t index) noexcept { return _element(m_start + index); }
+    [[nodiscard]] const _T& operator[](size_t index) const noexcept { return _element(m_start + index); }
+
+    [[nodiscard]] _T& front() noexcept { return _element(m_start); }
+    [[nodiscard]] const _T& front() const noexcept { return _element(m_start); }
+
+    [[nodiscard]] _T& back() noexcept { return _element(m_start + m_size - 1); }
+    [[nodiscard]] const _T& back() const noexcept { return _element(m_start + m_size - 1); }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(m_map.data(), m_start); }
+    [[nodiscard]] iterator end() noexcept { return iterator(m_map.data(), m_start + m_size); }
+    [[nodiscard]] const_iterator begin() const noexcept { return const_iterator(m_map.data(), m_start); }
+    [[nodiscard]] const_iterator end() const noexcept { return const_iterator(m_map.data(), m_start + m_size); }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    [[nodiscard]] reverse_const_iterator crbegin() const noexcept { return reverse_const_iterator(cend()); }
+    [[nodiscard]] reverse_const_iterator crend() const noexcept { return reverse_const_iterator(cbegin()); }
+
+    template <typename ... _Args>
+    _T& emplace_back(_Args&& ... args) {
+      size_t pos = m_start + m_size;
+      if ((pos >> _block_shift) >= m_map.size()) {
+        _remap(true);
+        pos = m_start + m_size;
+      }
+      _T* slot = _slot(pos);
+      _alloc_traits::construct(m_alloc, slot, std::forward<_Args>(args)...);
+      m_size += 1;
+      return *slot;
+    }
+
+    template <typename ... _Args>
+    _T& emplace_front(_Args&& ... args) {
+      if (m_start == 0) {
+        _remap(false);
+      }
+      _T* slot = _slot(m_start - 1);
+      _alloc_traits::construct(m_alloc, slot, std::forward<_Args>(args)...);
+      m_start -= 1;
+      m_size += 1;
+      return *slot;
+    }
+
+    void push_back(const _T& item) { emplace_back(item); }
+    void push_back(_T&& item) { emplace_back(std::move(item)); }
+
+    void push_front(const _T& item) { emplace_front(item); }
+    void push_front(_T&& item) { emplace_front(std::move(item)); }
+
+    _T pop_back() {
+      assert(m_size != 0);
+      size_t pos = m_start + m_size - 1;
+      _T item = std::move(_element(pos));
+      _alloc_traits::destroy(m_alloc, &_element(pos));
+      m_size -= 1;
+      if ((pos & _block_mask) == 0 || m_size == 0) {
+        _free_block(pos >> _block_shift);
+      }
+      return item;
+    }
+
+    _T pop_front() {
+      assert(m_size != 0);
+      size_t pos = m_start;
+      _T item = std::move(_element(pos));
+      _alloc_traits::destroy(m_alloc, &_element(pos));
+      m_start += 1;
+      m_size -= 1;
+      if ((m_start & _block_mask) == 0 || m_size == 0) {
+        _free_block(pos >> _block_shift);
+      }
+      return item;
+    }
+
+    void clear() noexcept {
+      for (size_t i = 0; i < m_size; ++i) {
+        _alloc_traits::destroy(m_alloc, &_element(m_start + i));
+      }
+      for (_T*& block : m_map) {
+        if (block) {
+          _deallocate_block(block);
+          block = nullptr;
+        }
+      }
+      m_start = (m_map.size() / 2) << _block_shift;
+      m_size = 0;
+    }
+
+    // Returns the cached spare block and trims the map to the blocks in use
+    void shrink_to_fit() {
+      _release_spare();
+      if (m_size == 0) {
+        m_map.clear();
+        m_map.shrink_to_fit();
+        m_start = 0;
+        return;
+      }
+      size_t first = m_start >> _block_shift;
+      size_t count = ((m_start + m_size - 1) >> _block_shift) - first + 1;
+      JMK::vector<_T*, _map_alloc> map(m_map.get_allocator());
+      map.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        map.push_back(m_map[first + i]);
+      }
+      m_map = std::move(map);
+      m_start &= _block_mask;
+    }
+
+  private:
+    static constexpr size_t _block_shift = std::countr_zero(block_size);
+    static constexpr size_t _block_mask = block_size - 1;
+    static constexpr size_t _min_map_size = 8;
+
+    [[nodiscard]] _T& _element(size_t pos) const noexcept {
+      return m_map[pos >> _block_shift][pos & _block_mask];
+    }
+
+    // Slot for an element about to be constructed, allocating its block
+    _T* _slot(size_t pos) {
+      _T*& block = m_map[pos >> _block_shift];
+      if (block == nullptr) {
+        if (m_spare) {
+          block = m_spare;
+          m_spare = nullptr;
+        }
+        else {
+          block = _alloc_traits::allocate(m_alloc, block_size);
+        }
+      }
+      return block + (pos & _block_mask);
+    }
+
+    // Keeps one emptied block around so a deque hovering at a block boundary
+    // does not hit the allocator on every push and pop
+    void _free_block(size_t index) noexcept {
+      _T*& block = m_map[index];
+      if (m_spare == nullptr) {
+        m_spare = block;
+      }
+      else {
+        _deallocate_block(block);
+      }
+      block = nullptr;
+    }
+
+    void _release_spare() noexcept {
+      if (m_spare) {
+        _deallocate_block(m_spare);
+        m_spare = nullptr;
+      }
+    }
+
+    void _deallocate_block(_T* block) noexcept {
+      _alloc_traits::deallocate(m_alloc, block, block_size);
+    }
+
+    // Makes room for one more block at the back or the front. Only block
+    // pointers move; the map is recentred in place when it is less than half
+    // full and doubled otherwise.
+    void _remap(bool at_back) {
+      size_t first = m_start >> _block_shift;
+      size_t used = m_size == 0 ? 0 : ((m_start + m_size - 1) >> _block_shift) - first + 1;
+      size_t needed = used + 1;
+
+      size_t map_size = m_map.size();
+      if (map_size == 0 || needed * 2 > map_size) {
+        map_size = std::max(map_size * 2, std::max(_min_map_size, needed * 2));
+      }
+
+      // Leave the free room on the side that is growing
+      size_t new_first = (map_size - needed) / 2 + (at_back ? 0 : 1);
+      if (map_size == m_map.size()) {
+        if (new_first < first) {
+          std::move(m_map.data() + first, m_map.data() + first + used, m_map.data() + new_first);
+          std::fill(m_map.data() + std::max(new_first + used, first), m_map.data() + first + used, nullptr);
+        }
+        else if (new_first > first) {
+          std::move_backward(m_map.data() + first, m_map.data() + first + used, m_map.data() + new_first + used);
+          std::fill(m_map.data() + first, m_map.data() + std::min(new_first, first + used), nullptr);
+        }
+      }
+      else {
+        JMK::vector<_T*, _map_alloc> map(m_map.get_allocator());
+        map.reserve(map_size);
+        map.resize(map_size);
+        for (size_t i = 0; i < used; ++i) {
+          map[new_first + i] = m_map[first + i];
+        }
+        m_map = std::move(map);
+      }
+      m_start = (new_first << _block_shift) + (m_start & _block_mask);
+    }
+
+    JMK::vector<_T*, _map_alloc> m_map;
+    size_t m_start = 0;
+    size_t m_size = 0;
+    _T* m_spare = nullptr;
+    [[no_unique_address]] _Alloc m_alloc;
+  };
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "traits.hpp"
+
+namespace JMK {
+
+  namespace _hash {
+
+    inline constexpr uint64_t _secret[4] = {
+      0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+    };
+
+    // Multiplies into 128 bits and folds the halves together
+    [[nodiscard]] inline uint64_t _mix(uint64_t a, uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+      unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+      return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+      uint64_t a_lo = uint32_t(a), a_hi = a >> 32, b_lo = uint32_t(b), b_hi = b >> 32;
+      uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+      uint64_t cross = (lo_lo >> 32) + uint32_t(hi_lo) + lo_hi;
+      uint64_t high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+      return ((cross << 32) | uint32_t(lo_lo)) ^ high;
+#endif
+    }
+
+    [[nodiscard]] inline uint64_t _read8(const unsigned char* p) noexcept {
+      uint64_t v;
+      std::memcpy(&v, p, sizeof(v));
+      return v;
+    }
+
+    [[nodiscard]] inline uint64_t _read4(const unsigned char* p) noexcept {
+      uint32_t v;
+      std::memcpy(&v, p, sizeof(v));
+      return v;
+    }
+
+  }
+
+  // 64-bit hash of raw memory in the style of wyhash: inputs are consumed 48
+  // bytes at a time in three independent multiply-fold lanes, and short keys
+  // take a branch or two without a loop. Results depend on byte order, so
+  // they are not meant to be persisted across platforms.
+  [[nodiscard]] inline uint64_t hash_bytes(const void* key, size_t size, uint64_t seed = 0) noexcept {
+    using namespace _hash;
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+    seed ^= _mix(seed ^ _secret[0], _secret[1]);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16) {
+      if (size >= 4) {
+        size_t step = (size >> 3) << 2;
+        a = (_read4(p) << 32) | _read4(p + step);
+        b = (_read4(p + size - 4) << 32) | _read4(p + size - 4 - step);
+      }
+      else if (size > 0) {
+        a = (uint64_t(p[0]) << 16) | (uint64_t(p[size >> 1]) << 8) | p[size - 1];
+      }
+    }
+    else {
+      size_t left = size;
+      if (left > 48) {
+        uint64_t lane1 = seed;
+        uint64_t lane2 = seed;
+        do {
+          seed = _mix(_read8(p) ^ _secret[1], _read8(p + 8) ^ seed);
+          lane1 = _mix(_read8(p + 16) ^ _secret[2], _read8(p + 24) ^ lane1);
+          lane2 = _mix(_read8(p + 32) ^ _secret[3], _read8(p + 40) ^ lane2);
+          p += 48;
+          left -= 48;
+        } while (left > 48);
+        seed ^= lane1 ^ lane2;
+      }
+      while (left > 16) {
+        seed = _mix(_read8(p) ^ _secret[1], _read8(p + 8) ^ seed);
+        p += 16;
+        left -= 16;
+      }
+      // The last 16 bytes, overlapping what was already consumed if need be
+      a = _read8(p + left - 16);
+      b = _read8(p + left - 8);
+    }
+    a ^= _secret[1];
+    b ^= seed;
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t folded = _mix(a, b);
+    a ^= folded;
+    b ^= folded;
+#endif
+    return _mix(a ^ _secret[0] ^ size, b ^ _secret[1]);
+  }
+
+  // Types a contiguous range of which can be hashed by hash_range
+  template <typename _T>
+  concept range_hashable = JMK::is_bitwise_comparable_v<_T> || requires(const _T& value) {
+    { std::hash<_T>{}(value) } -> std::convertible_to<size_t>;
+  };
+
+  // Hash of a contiguous range that agrees with equal_ranges: bitwise
+  // comparable elements are hashed as one block of bytes, anything else
+  // element by element through std::hash
+  template <range_hashable _T>
+  [[nodiscard]] size_t hash_range(const _T* data, size_t count) noexcept {
+    if constexpr (JMK::is_bitwise_comparable_v<_T>) {
+      return static_cast<size_t>(hash_bytes(data, count * sizeof(_T)));
+    }
+    else {
+      using namespace _hash;
+      uint64_t h = _mix(count ^ _secret[0], _secret[1]);
+      for (size_t i = 0; i < count; ++i) {
+        h = _mix(h ^ static_cast<uint64_t>(std::hash<_T>{}(data[i])), _secret[2]);
+      }
+      return static_cast<size_t>(_mix(h ^ _secret[3], count ^ _secret[1]));
+    }
+  }
+
+}
@@ -0,0 +1,503 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace JMK {
+
+  // JMK::list with O(log n) positional access. Besides the prev/next links
+  // that keep iteration O(1), every node sits in an implicit treap ordered by
+  // list position and augmented with its subtree size, so at(i), insert_at(i),
+  // erase_at(i), index_of(it) and iterator jumps all descend or climb the
+  // tree instead of walking the chain.
+  template <typename _T>
+  class indexed_list {
+    struct _link {
+      _link* m_next = nullptr;
+      _link* m_prev = nullptr;
+      _link* m_parent = nullptr;
+      _link* m_left = nullptr;
+      _link* m_right = nullptr;
+      size_t m_count = 0;
+      uint32_t m_priority = 0;
+    };
+
+    struct _node : _link {
+      template <typename ... _Args>
+      _node(_Args&& ... args) : m_item(std::forward<_Args>(args)...) {}
+
+      _T m_item;
+    };
+
+    // Jumps shorter than this step along the chain instead of using the tree
+    static constexpr size_t _walk_limit = 16;
+
+  public:
+    template <typename _V>
+    class basic_iterator {
+      friend class JMK::indexed_list<_T>;
+
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = std::remove_cv_t<_V>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = _V*;
+      using reference = _V&;
+
+      basic_iterator() noexcept = default;
+      basic_iterator(_link* link) noexcept : m_link(link) {}
+
+      template <typename _W> requires (std::is_const_v<_V> && !std::is_const_v<_W>)
+      basic_iterator(const basic_iterator<_W>& other) noexcept : m_link(other.m_link) {}
+
+      [[nodiscard]] reference operator*() const noexcept { return static_cast<_node*>(m_link)->m_item; }
+      [[nodiscard]] pointer operator->() const noexcept { return &operator*(); }
+
+      basic_iterator& operator++() noexcept {
+        m_link = m_link->m_next;
+        return *this;
+      }
+
+      basic_iterator operator++(int) noexcept {
+        basic_iterator copy = *this;
+        m_link = m_link->m_next;
+        return copy;
+      }
+
+      basic_iterator& operator--() noexcept {
+        m_link = m_link->m_prev;
+        return *this;
+      }
+
+      basic_iterator operator--(int) noexcept {
+        basic_iterator copy = *this;
+        m_link = m_link->m_prev;
+        return copy;
+      }
+
+      [[nodiscard]] basic_iterator operator+(difference_type i) const noexcept {
+        return basic_iterator(_advance(m_link, i));
+      }
+
+      [[nodiscard]] basic_iterator operator-(difference_type i) const noexcept {
+        return basic_iterator(_advance(m_link, -i));
+      }
+
+      [[nodiscard]] difference_type operator-(const basic_iterator& other) const noexcept {
+        return static_cast<difference_type>(_index_of(m_link)) - static_cast<difference_type>(_index_of(other.m_link));
+      }
+
+      [[nodiscard]] bool operator==(const basic_iterator& other) const noexcept { return m_link == other.m_link; }
+
+      [[nodiscard]] std::strong_ordering operator<=>(const basic_iterator& other) const noexcept {
+        return _index_of(m_link) <=> _index_of(other.m_link);
+      }
+
+    private:
+      template <typename _W>
+      friend class basic_iterator;
+
+      _link* m_link = nullptr;
+    };
+
+    using iterator = basic_iterator<_T>;
+    using const_iterator = basic_iterator<const _T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    indexed_list() noexcept {
+      _reset_header();
+    }
+
+    indexed_list(const indexed_list& other) : indexed_list() {
+      _copy_from(other);
+    }
+
+    indexed_list(indexed_list&& other) noexcept : indexed_list() {
+      _move_from(std::move(other));
+    }
+
+    indexed_list(_T _fill, size_t size) : indexed_list() {
+      resize(size);
+      fill(_fill);
+    }
+
+    indexed_list(std::initializer_list<_T> list) : indexed_list() {
+      for (const _T& item : list) {
+        emplace_back(item);
+      }
+    }
+
+    ~indexed_list() {
+      clear();
+    }
+
+    indexed_list& operator=(const indexed_list& other) {
+      if (this != &other) {
+        clear();
+        _copy_from(other);
+      }
+      return *this;
+    }
+
+    indexed_list& operator=(indexed_list&& other) noexcept {
+      if (this != &other) {
+        clear();
+        _move_from(std::move(other));
+      }
+      return *this;
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return _count(m_header.m_left); }
+    [[nodiscard]] size_t max_size() const noexcept { return std::numeric_limits<size_t>::max(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_header.m_left == nullptr; }
+
+    [[nodiscard]] _T& at(size_t index) {
+      assert(index < size());
+      return static_cast<_node*>(_nth(index))->m_item;
+    }
+
+    [[nodiscard]] const _T& at(size_t index) const {
+      assert(index < size());
+      return static_cast<_node*>(_nth(index))->m_item;
+    }
+
+    [[nodiscard]] _T& operator[](size_t index) noexcept {
+      return static_cast<_node*>(_nth(index))->m_item;
+    }
+
+    [[nodiscard]] const _T& operator[](size_t index) const noexcept {
+      return static_cast<_node*>(_nth(index))->m_item;
+    }
+
+    [[nodiscard]] _T& front() noexcept { return *begin(); }
+    [[nodiscard]] const _T& front() const noexcept { return *begin(); }
+
+    [[nodiscard]] _T& back() noexcept { return *--end(); }
+    [[nodiscard]] const _T& back() const noexcept { return *--end(); }
+
+    // Position of it in the list; end() maps to size()
+    [[nodiscard]] size_t index_of(const_iterator it) const noexcept { return _index_of(it.m_link); }
+
+    void resize(size_t new_size) {
+      while (size() > new_size) {
+        pop_back();
+      }
+      while (size() < new_size) {
+        emplace_back();
+      }
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(m_header.m_next); }
+    [[nodiscard]] iterator end() noexcept { return iterator(&m_header); }
+    [[nodiscard]] const_iterator begin() const noexcept { return const_iterator(m_header.m_next); }
+    [[nodiscard]] const_iterator end() const noexcept { return const_iterator(_header()); }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    [[nodiscard]] reverse_const_iterator crbegin() const noexcept { return reverse_const_iterator(cend()); }
+    [[nodiscard]] reverse_const_iterator crend() const noexcept { return reverse_const_iterator(cbegin()); }
+
+    template <typename ... _Args>
+    void emplace_back(_Args&& ... args) {
+      emplace(end(), std::forward<_Args>(args)...);
+    }
+
+    void push_back(const _T& value) {
+      emplace(end(), value);
+    }
+
+    void push_back(_T&& value) {
+      emplace(end(), std::move(value));
+    }
+
+    _T pop_back() {
+      assert(!empty());
+      _T value = std::move(back());
+      erase(--end());
+      return value;
+    }
+
+    template <typename ... _Args>
+    iterator emplace(const_iterator pos, _Args&& ... args) {
+      _node* n = new _node(std::forward<_Args>(args)...);
+      _insert_before(n, pos.m_link);
+      return iterator(n);
+    }
+
+    iterator insert(const_iterator pos, const _T& value) {
+      return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, _T&& value) {
+      return emplace(pos, std::move(value));
+    }
+
+    template <typename ... _Args>
+    iterator emplace_at(size_t index, _Args&& ... args) {
+      assert(index <= size());
+      return emplace(const_iterator(_nth(index)), std::forward<_Args>(args)...);
+    }
+
+    iterator insert_at(size_t index, const _T& value) {
+      return emplace_at(index, value);
+    }
+
+    iterator insert_at(size_t index, _T&& value) {
+      return emplace_at(index, std::move(value));
+    }
+
+    iterator erase(const_iterator pos) noexcept(std::is_nothrow_destructible_v<_T>) {
+      _link* next = pos.m_link->m_next;
+      _remove(pos.m_link);
+      delete static_cast<_node*>(pos.m_link);
+      return iterator(next);
+    }
+
+    iterator erase(const_iterator _beg, const_iterator _end) noexcept(std::is_nothrow_destructible_v<_T>) {
+      while (_beg != _end) {
+        _beg = erase(_beg);
+      }
+      return iterator(_end.m_link);
+    }
+
+    iterator erase_at(size_t index) noexcept(std::is_nothrow_destructible_v<_T>) {
+      assert(index < size());
+      return erase(const_iterator(_nth(index)));
+    }
+
+    void clear() noexcept {
+      _link* link = m_header.m_next;
+      while (link != &m_header) {
+        _link* next = link->m_next;
+        delete static_cast<_node*>(link);
+        link = next;
+      }
+      _reset_header();
+    }
+
+    void fill(_T v) {
+      for (auto it = begin(); it != end(); ++it) {
+        *it = v;
+      }
+    }
+
+    void reset() {
+      fill(_T());
+    }
+
+  private:
+    // The header is the end() sentinel of the chain and the parent of the
+    // tree root, which it keeps in m_left. It is the only link without a parent.
+    [[nodiscard]] _link* _header() const noexcept { return const_cast<_link*>(&m_header); }
+
+    void _reset_header() noexcept {
+      m_header.m_next = &m_header;
+      m_header.m_prev = &m_header;
+      m_header.m_parent = nullptr;
+      m_header.m_left = nullptr;
+      m_header.m_right = nullptr;
+    }
+
+    [[nodiscard]] static size_t _count(const _link* link) noexcept { return link ? link->m_count : 0; }
+
+    [[nodiscard]] static _link* _find_header(_link* link) noexcept {
+      while (link->m_parent) {
+        link = link->m_parent;
+      }
+      return link;
+    }
+
+    [[nodiscard]] static size_t _index_of(_link* link) noexcept {
+      if (link->m_parent == nullptr) {
+        return _count(link->m_left);
+      }
+      size_t index = _count(link->m_left);
+      while (link->m_parent->m_parent) {
+        if (link == link->m_parent->m_right) {
+          index += _count(link->m_parent->m_left) + 1;
+        }
+        link = link->m_parent;
+      }
+      return index;
+    }
+
+    [[nodiscard]] static _link* _nth_from(_link* header, size_t index) noexcept {
+      _link* link = header->m_left;
+      if (index >= _count(link)) {
+        return header;
+      }
+      for (;;) {
+        size_t left = _count(link->m_left);
+        if (index < left) {
+          link = link->m_left;
+        }
+        else if (index == left) {
+          return link;
+        }
+        else {
+          index -= left + 1;
+          link = link->m_right;
+        }
+      }
+    }
+
+    [[nodiscard]] _link* _nth(size_t index) const noexcept { return _nth_from(_header(), index); }
+
+    [[nodiscard]] static _link* _advance(_link* link, std::ptrdiff_t i) noexcept {
+      if (static_cast<size_t>(i < 0 ? -i : i) < _walk_limit) {
+        for (; i > 0; --i) {
+          link = link->m_next;
+        }
+        for (; i < 0; ++i) {
+          link = link->m_prev;
+        }
+        return link;
+      }
+      return _nth_from(_find_header(link), static_cast<size_t>(static_cast<std::ptrdiff_t>(_index_of(link)) + i));
+    }
+
+    [[nodiscard]] uint32_t _next_priority() noexcept {
+      m_seed ^= m_seed << 13;
+      m_seed ^= m_seed >> 17;
+      m_seed ^= m_seed << 5;
+      return m_seed;
+    }
+
+    // Makes y = x->m_right take x's place
+    static void _rotate_left(_link* x) noexcept {
+      _link* y = x->m_right;
+      x->m_right = y->m_left;
+      if (y->m_left) {
+        y->m_left->m_parent = x;
+      }
+      _replace_child(x, y);
+      y->m_left = x;
+      x->m_parent = y;
+      y->m_count = x->m_count;
+      x->m_count = 1 + _count(x->m_left) + _count(x->m_right);
+    }
+
+    // Makes y = x->m_left take x's place
+    static void _rotate_right(_link* x) noexcept {
+      _link* y = x->m_left;
+      x->m_left = y->m_right;
+      if (y->m_right) {
+        y->m_right->m_parent = x;
+      }
+      _replace_child(x, y);
+      y->m_right = x;
+      x->m_parent = y;
+      y->m_count = x->m_count;
+      x->m_count = 1 + _count(x->m_left) + _count(x->m_right);
+    }
+
+    static void _replace_child(_link* x, _link* y) noexcept {
+      _link* parent = x->m_parent;
+      y->m_parent = parent;
+      if (parent->m_left == x) {
+        parent->m_left = y;
+      }
+      else {
+        parent->m_right = y;
+      }
+    }
+
+    // Attaches n as the in-order predecessor of at, then restores the heap
+    // order on priorities with rotations
+    void _insert_before(_link* n, _link* at) noexcept {
+      n->m_count = 1;
+      n->m_priority = _next_priority();
+
+      if (at == &m_header ? m_header.m_left == nullptr : at->m_left == nullptr) {
+        at->m_left = n;
+        n->m_parent = at;
+      }
+      else {
+        // The predecessor is the rightmost node of at's left subtree
+        _link* prev = at->m_prev;
+        prev->m_right = n;
+        n->m_parent = prev;
+      }
+
+      n->m_next = at;
+      n->m_prev = at->m_prev;
+      at->m_prev->m_next = n;
+      at->m_prev = n;
+
+      for (_link* p = n->m_parent; p != &m_header; p = p->m_parent) {
+        p->m_count += 1;
+      }
+      while (n->m_parent != &m_header && n->m_priority > n->m_parent->m_priority) {
+        if (n == n->m_parent->m_left) {
+          _rotate_right(n->m_parent);
+        }
+        else {
+          _rotate_left(n->m_parent);
+        }
+      }
+    }
+
+    // Rotates n down to a leaf, then cuts it out of both structures
+    void _remove(_link* n) noexcept {
+      while (n->m_left || n->m_right) {
+        if (n->m_right == nullptr || (n->m_left && n->m_left->m_priority > n->m_right->m_priority)) {
+          _rotate_right(n);
+        }
+        else {
+          _rotate_left(n);
+        }
+      }
+      _link* parent = n->m_parent;
+      if (parent->m_left == n) {
+        parent->m_left = nullptr;
+      }
+      else {
+        parent->m_right = nullptr;
+      }
+      for (_link* p = parent; p != &m_header; p = p->m_parent) {
+        p->m_count -= 1;
+      }
+
+      n->m_prev->m_next = n->m_next;
+      n->m_next->m_prev = n->m_prev;
+    }
+
+    void _copy_from(const indexed_list& other) {
+      for (const _T& item : other) {
+        emplace_back(item);
+      }
+    }
+
+    void _move_from(indexed_list&& other) noexcept {
+      if (other.empty()) {
+        return;
+      }
+      m_header.m_next = other.m_header.m_next;
+      m_header.m_prev = other.m_header.m_prev;
+      m_header.m_left = other.m_header.m_left;
+      // The first, last and root nodes still point at the other list's header
+      m_header.m_next->m_prev = &m_header;
+      m_header.m_prev->m_next = &m_header;
+      m_header.m_left->m_parent = &m_header;
+      other._reset_header();
+    }
+
+    _link m_header;
+    uint32_t m_seed = 0x9E3779B9u;
+  };
+
+}
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+// Allocation and growth instrumentation for the JMK containers. Define
+// JMK_INSTRUMENT before including any JMK header (or on the command line) to
+// turn it on; without it every probe is an empty member whose hooks compile
+// to nothing.
+//
+// Each container instance keeps its own counters, read with
+// instrumentation(), and also adds them to one aggregate per container type.
+// Only the aggregates keep the growth histogram, so an instance carries just
+// its counters. The aggregates are shared between threads and can be dumped
+// as JSON or Prometheus text.
+
+namespace JMK::instrument {
+
+  inline constexpr size_t growth_buckets = 64;
+
+  // Counts of one container instance
+  struct counters {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_freed = 0;
+    // Growths that replaced an existing block, and the bytes of live
+    // elements relocated by them or by any other reshuffle
+    uint64_t reallocations = 0;
+    uint64_t bytes_moved = 0;
+    // Largest capacity reached, in elements (list: live nodes)
+    uint64_t peak_capacity = 0;
+
+    constexpr counters& operator+=(const counters& other) noexcept {
+      allocations += other.allocations;
+      deallocations += other.deallocations;
+      bytes_allocated += other.bytes_allocated;
+      bytes_freed += other.bytes_freed;
+      reallocations += other.reallocations;
+      bytes_moved += other.bytes_moved;
+      peak_capacity = std::max(peak_capacity, other.peak_capacity);
+      return *this;
+    }
+  };
+
+  // Counts of one container type, summed over its instances, with the
+  // distribution of the capacities they grew to
+  struct stats : counters {
+    // growth[i] counts growths whose new capacity had bit width i, so the
+    // bucket holds capacities in [2^(i-1), 2^i)
+    std::array<uint64_t, growth_buckets> growth{};
+    uint64_t growth_capacity_sum = 0;
+
+    constexpr stats& operator+=(const stats& other) noexcept {
+      counters::operator+=(other);
+      for (size_t i = 0; i < growth_buckets; ++i) {
+        growth[i] += other.growth[i];
+      }
+      growth_capacity_sum += other.growth_capacity_sum;
+      return *this;
+    }
+  };
+
+  namespace _detail {
+
+    [[nodiscard]] constexpr size_t _bucket(size_t capacity) noexcept {
+      return std::min<size_t>(static_cast<size_t>(std::bit_width(capacity)), growth_buckets - 1);
+    }
+
+    inline void _max(std::atomic<uint64_t>& target, uint64_t value) noexcept {
+      uint64_t current = target.load(std::memory_order_relaxed);
+      while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+      }
+    }
+
+    // Running totals for one container type. Updated with relaxed atomics
+    // since only the final counts matter, not their order.
+    struct _aggregate {
+      std::string type;
+      std::atomic<uint64_t> allocations{ 0 };
+      std::atomic<uint64_t> deallocations{ 0 };
+      std::atomic<uint64_t> bytes_allocated{ 0 };
+      std::atomic<uint64_t> bytes_freed{ 0 };
+      std::atomic<uint64_t> reallocations{ 0 };
+      std::atomic<uint64_t> bytes_moved{ 0 };
+      std::atomic<uint64_t> peak_capacity{ 0 };
+      std::array<std::atomic<uint64_t>, growth_buckets> growth{};
+      std::atomic<uint64_t> growth_capacity_sum{ 0 };
+
+      [[nodiscard]] stats load() const noexcept {
+        stats out;
+        out.allocations = allocations.load(std::memory_order_relaxed);
+        out.deallocations = deallocations.load(std::memory_order_relaxed);
+        out.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+        out.bytes_freed = bytes_freed.load(std::memory_order_relaxed);
+        out.reallocations = reallocations.load(std::memory_order_relaxed);
+        out.bytes_moved = bytes_moved.load(std::memory_order_relaxed);
+        out.peak_capacity = peak_capacity.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < growth_buckets; ++i) {
+          out.growth[i] = growth[i].load(std::memory_order_relaxed);
+        }
+        out.growth_capacity_sum = growth_capacity_sum.load(std::memory_order_relaxed);
+        return out;
+      }
+    };
+
+    // Every aggregate ever created, in creation order. Aggregates live for
+    // the whole program, so the registry hands out plain pointers.
+    class _registry {
+    public:
+      static _registry& get() {
+        static _registry instance;
+        return instance;
+      }
+
+      _aggregate& add(std::string type) {
+        std::lock_guard lock(m_mutex);
+        m_aggregates.push_back(std::make_unique<_aggregate>());
+        m_aggregates.back()->type = std::move(type);
+        return *m_aggregates.back();
+      }
+
+      template <typename _Fn>
+      void for_each(_Fn&& fn) {
+        std::lock_guard lock(m_mutex);
+        for (const auto& a : m_aggregates) {
+          fn(*a);
+        }
+      }
+
+    private:
+      std::mutex m_mutex;
+      std::vector<std::unique_ptr<_aggregate>> m_aggregates;
+    };
+
+    // Readable name of _T where the compiler can spell it, mangled otherwise
+    template <typename _T>
+    std::string _type_name() {
+#if defined(__clang__) || defined(__GNUC__)
+      std::string_view name = __PRETTY_FUNCTION__;
+      size_t begin = name.find("_T = ");
+      if (begin != std::string_view::npos) {
+        begin += 5;
+        size_t end = name.find_first_of(";]", begin);
+        return std::string(name.substr(begin, end - begin));
+      }
+#endif
+      return typeid(_T).name();
+    }
+
+    template <typename _Owner>
+    _aggregate& _aggregate_of() {
+      static _aggregate& aggregate = _registry::get().add(_type_name<_Owner>());
+      return aggregate;
+    }
+
+    inline void _write_counters(std::ostream& os, const counters& c) {
+      os << "\"allocations\": " << c.allocations
+        << ", \"deallocations\": " << c.deallocations
+        << ", \"bytes_allocated\": " << c.bytes_allocated
+        << ", \"bytes_freed\": " << c.bytes_freed
+        << ", \"reallocations\": " << c.reallocations
+        << ", \"bytes_moved\": " << c.bytes_moved
+        << ", \"peak_capacity\": " << c.peak_capacity;
+    }
+
+    inline void _escape(std::ostream& os, std::string_view text) {
+      for (char c : text) {
+        if (c == '"' || c == '\\') {
+          os << '\\';
+        }
+        os << c;
+      }
+    }
+
+  }
+
+#if defined(JMK_INSTRUMENT)
+
+  // Per instance counts of one container, also added to the aggregate of
+  // _Owner. Copies start from zero; moves carry the counts along with the
+  // storage they describe.
+  template <typename _Owner>
+  class probe {
+  public:
+    constexpr probe() noexcept = default;
+    constexpr probe(const probe&) noexcept {}
+
+    constexpr probe(probe&& other) noexcept : m_counts(std::exchange(other.m_counts, counters{})) {}
+
+    constexpr probe& operator=(const probe&) noexcept { return *this; }
+
+    constexpr probe& operator=(probe&& other) noexcept {
+      if (this != &other) {
+        m_counts += std::exchange(other.m_counts, counters{});
+      }
+      return *this;
+    }
+
+    [[nodiscard]] constexpr const counters& get() const noexcept { return m_counts; }
+
+    constexpr void on_allocate(size_t bytes) noexcept {
+      m_counts.allocations += 1;
+      m_counts.bytes_allocated += bytes;
+      if (!std::is_constant_evaluated()) {
+        auto& a = _detail::_aggregate_of<_Owner>();
+        a.allocations.fetch_add(1, std::memory_order_relaxed);
+        a.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+      }
+    }
+
+    constexpr void on_deallocate(size_t bytes) noexcept {
+      m_counts.deallocations += 1;
+      m_counts.bytes_freed += bytes;
+      if (!std::is_constant_evaluated()) {
+        auto& a = _detail::_aggregate_of<_Owner>();
+        a.deallocations.fetch_add(1, std::memory_order_relaxed);
+        a.bytes_freed.fetch_add(bytes, std::memory_order_relaxed);
+      }
+    }
+
+    // Capacity went from old_capacity to new_capacity elements, relocating
+    // bytes_moved bytes of live elements on the way
+    constexpr void on_grow(size_t old_capacity, size_t new_capacity, size_t bytes_moved) noexcept {
+      m_counts.reallocations += old_capacity != 0;
+      m_counts.bytes_moved += bytes_moved;
+      m_counts.peak_capacity = std::max<uint64_t>(m_counts.peak_capacity, new_capacity);
+      if (!std::is_constant_evaluated()) {
+        auto& a = _detail::_aggregate_of<_Owner>();
+        a.reallocations.fetch_add(old_capacity != 0, std::memory_order_relaxed);
+        a.bytes_moved.fetch_add(bytes_moved, std::memory_order_relaxed);
+        a.growth[_detail::_bucket(new_capacity)].fetch_add(1, std::memory_order_relaxed);
+        a.growth_capacity_sum.fetch_add(new_capacity, std::memory_order_relaxed);
+        _detail::_max(a.peak_capacity, new_capacity);
+      }
+    }
+
+    // Live elements were relocated without the capacity changing
+    constexpr void on_move(size_t bytes) noexcept {
+      m_counts.bytes_moved += bytes;
+      if (!std::is_constant_evaluated()) {
+        _detail::_aggregate_of<_Owner>().bytes_moved.fetch_add(bytes, std::memory_order_relaxed);
+      }
+    }
+
+    constexpr void on_capacity(size_t capacity) noexcept {
+      m_counts.peak_capacity = std::max<uint64_t>(m_counts.peak_capacity, capacity);
+      if (!std::is_constant_evaluated()) {
+        _detail::_max(_detail::_aggregate_of<_Owner>().peak_capacity, capacity);
+      }
+    }
+
+  private:
+    counters m_counts;
+  };
+
+#else
+
+  template <typename _Owner>
+  class probe {
+  public:
+    [[nodiscard]] constexpr counters get() const noexcept { return {}; }
+
+    constexpr void on_allocate(size_t) noexcept {}
+    constexpr void on_deallocate(size_t) noexcept {}
+    constexpr void on_grow(size_t, size_t, size_t) noexcept {}
+    constexpr void on_move(size_t) noexcept {}
+    constexpr void on_capacity(size_t) noexcept {}
+  };
+
+#endif
+
+  // The aggregate of every instrumented container type used so far
+  [[nodiscard]] inline std::vector<std::pair<std::string, stats>> snapshot() {
+    std::vector<std::pair<std::string, stats>> out;
+    _detail::_registry::get().for_each([&](const _detail::_aggregate& a) {
+      out.emplace_back(a.type, a.load());
+    });
+    return out;
+  }
+
+  inline void write_json(std::ostream& os, const counters& c) {
+    os << '{';
+    _detail::_write_counters(os, c);
+    os << '}';
+  }
+
+  inline void write_json(std::ostream& os, const stats& s) {
+    os << '{';
+    _detail::_write_counters(os, s);
+    os << ", \"growth\": {";
+    bool first = true;
+    for (size_t i = 0; i < growth_buckets; ++i) {
+      if (s.growth[i] != 0) {
+        // Keyed by the exclusive upper bound of the bucket
+        os << (first ? "" : ", ") << "\"" << (uint64_t(1) << i) << "\": " << s.growth[i];
+        first = false;
+      }
+    }
+    os << "}}";
+  }
+
+  // {"<type>": {...}, ...} over every aggregate
+  inline void write_json(std::ostream& os) {
+    os << "{";
+    bool first = true;
+    for (const auto& [type, s] : snapshot()) {
+      os << (first ? "\n  \"" : ",\n  \"");
+      _detail::_escape(os, type);
+      os << "\": ";
+      write_json(os, s);
+      first = false;
+    }
+    os << "\n}\n";
+  }
+
+  // Prometheus text exposition of every aggregate, labelled by type. Growth
+  // is a histogram of the new capacities.
+  inline void write_prometheus(std::ostream& os) {
+    auto all = snapshot();
+    auto series = [&](const char* name, const char* kind, const char* help, uint64_t stats::* field) {
+      os << "# HELP jmk_" << name << ' ' << help << "\n# TYPE jmk_" << name << ' ' << kind << '\n';
+      for (const auto& [type, s] : all) {
+        os << "jmk_" << name << "{type=\"";
+        _detail::_escape(os, type);
+        os << "\"} " << s.*field << '\n';
+      }
+    };
+    series("allocations_total", "counter", "Storage blocks allocated.", &stats::allocations);
+    series("deallocations_total", "counter", "Storage blocks freed.", &stats::deallocations);
+    series("allocated_bytes_total", "counter", "Bytes of storage allocated.", &stats::bytes_allocated);
+    series("freed_bytes_total", "counter", "Bytes of storage freed.", &stats::bytes_freed);
+    series("reallocations_total", "counter", "Growths that replaced an existing block.", &stats::reallocations);
+    series("moved_bytes_total", "counter", "Bytes of live elements relocated.", &stats::bytes_moved);
+    series("peak_capacity", "gauge", "Largest capacity reached by one instance, in elements.", &stats::peak_capacity);
+
+    os << "# HELP jmk_growth_capacity New capacity of each growth, in elements.\n"
+      "# TYPE jmk_growth_capacity histogram\n";
+    for (const auto& [type, s] : all) {
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < growth_buckets; ++i) {
+        cumulative += s.growth[i];
+        if (s.growth[i] == 0 && i + 1 < growth_buckets) {
+          continue;
+        }
+        // Bucket i holds capacities below 2^i, so its inclusive bound is one less
+        os << "jmk_growth_capacity_bucket{type=\"";
+        _detail::_escape(os, type);
+        os << "\",le=\"";
+        if (i + 1 < growth_buckets) {
+          os << ((uint64_t(1) << i) - 1);
+        }
+        else {
+          os << "+Inf";
+        }
+        os << "\"} " << cumulative << '\n';
+      }
+      os << "jmk_growth_capacity_sum{type=\"";
+      _detail::_escape(os, type);
+      os << "\"} " << s.growth_capacity_sum << "\njmk_growth_capacity_count{type=\"";
+      _detail::_escape(os, type);
+      os << "\"} " << cumulative << '\n';
+    }
+  }
+
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace JMK {
+
+  // Links embedded in an object so that it can sit in an intrusive_list.
+  // A hook belongs to at most one list at a time.
+  class list_hook {
+    template <typename _T, list_hook _T::* _Hook>
+    friend class intrusive_list;
+
+  public:
+    list_hook() noexcept = default;
+
+    // Copying an object never copies its list membership
+    list_hook(const list_hook&) noexcept {}
+    list_hook& operator=(const list_hook&) noexcept { return *this; }
+
+    ~list_hook() {
+      assert(!is_linked());
+    }
+
+    [[nodiscard]] bool is_linked() const noexcept { return m_next != nullptr; }
+
+  private:
+    list_hook* m_next = nullptr;
+    list_hook* m_prev = nullptr;
+  };
+
+  namespace _detail {
+
+    // Storage shaped like _T that never holds one
+    template <typename _T>
+    union _layout_of {
+      constexpr _layout_of() noexcept : m_bytes() {}
+      constexpr ~_layout_of() {}
+
+      std::byte m_bytes[sizeof(_T)];
+      _T m_object;
+    };
+
+    template <typename _T>
+    inline constexpr _layout_of<_T> _layout{};
+
+    // Offset of the hook inside _T, or -1. Constant evaluation may not
+    // convert between pointer types but may compare addresses, so this walks
+    // the stand-in's bytes, at the hook's alignment, until one is the hook.
+    template <typename _T, list_hook _T::* _Hook>
+    [[nodiscard]] consteval std::ptrdiff_t _find_hook_offset() noexcept {
+      const void* hook = &(_layout<_T>.m_object.*_Hook);
+      for (size_t i = 0; i < sizeof(_T); i += alignof(list_hook)) {
+        if (hook == static_cast<const void*>(&_layout<_T>.m_bytes[i])) {
+          return static_cast<std::ptrdiff_t>(i);
+        }
+      }
+      return -1;
+    }
+
+    // A variable template, so _T only needs to be complete where a list
+    // actually reaches an element, not where the list type is named
+    template <typename _T, list_hook _T::* _Hook>
+    inline constexpr std::ptrdiff_t _hook_offset = _find_hook_offset<_T, _Hook>();
+
+  }
+
+  // Doubly linked list threaded through a list_hook member of _T. The list
+  // never allocates, copies or owns its elements: it links the caller's
+  // objects in place, and erase(_T&) unlinks any of them in O(1) without
+  // searching for it. The hook cannot unlink itself, since the list it is
+  // in has to keep its size. Objects must stay alive, and must not be moved,
+  // while they are linked.
+  template <typename _T, list_hook _T::* _Hook>
+  class intrusive_list {
+  public:
+    template <typename _V>
+    class basic_iterator {
+      friend class JMK::intrusive_list<_T, _Hook>;
+
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = std::remove_cv_t<_V>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = _V*;
+      using reference = _V&;
+
+      basic_iterator() noexcept = default;
+      basic_iterator(list_hook* hook) noexcept : m_hook(hook) {}
+
+      template <typename _W> requires (std::is_const_v<_V> && !std::is_const_v<_W>)
+      basic_iterator(const basic_iterator<_W>& other) noexcept : m_hook(other.m_hook) {}
+
+      [[nodiscard]] basic_iterator operator+(difference_type i) const noexcept {
+        if (i < 0) {
+          return operator-(-i);
+        }
+        basic_iterator copy = *this;
+        while (i > 0) {
+          copy.m_hook = copy.m_hook->m_next;
+          i -= 1;
+        }
+        return copy;
+      }
+
+      basic_iterator& operator++() noexcept {
+        m_hook = m_hook->m_next;
+        return *this;
+      }
+
+      basic_iterator operator++(int) noexcept {
+        basic_iterator copy = *this;
+        m_hook = m_hook->m_next;
+        return copy;
+      }
+
+      [[nodiscard]] basic_iterator operator-(difference_type i) const noexcept {
+        if (i < 0) {
+          return operator+(-i);
+        }
+        basic_iterator copy = *this;
+        while (i > 0) {
+          copy.m_hook = copy.m_hook->m_prev;
+          i -= 1;
+        }
+        return copy;
+      }
+
+      basic_iterator& operator--() noexcept {
+        m_hook = m_hook->m_prev;
+        return *this;
+      }
+
+      basic_iterator operator--(int) noexcept {
+        basic_iterator copy = *this;
+        m_hook = m_hook->m_prev;
+        return copy;
+      }
+
+      [[nodiscard]] reference operator*() const noexcept { return *_owner(m_hook); }
+      [[nodiscard]] pointer operator->() const noexcept { return _owner(m_hook); }
+
+      [[nodiscard]] bool operator==(const basic_iterator& other) const noexcept { return m_hook == other.m_hook; }
+
+    private:
+      template <typename _W>
+      friend class basic_iterator;
+
+      list_hook* m_hook = nullptr;
+    };
+
+    using iterator = basic_iterator<_T>;
+    using const_iterator = basic_iterator<const _T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    intrusive_list() noexcept {
+      m_root.m_next = &m_root;
+      m_root.m_prev = &m_root;
+    }
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    intrusive_list(intrusive_list&& other) noexcept : intrusive_list() {
+      _take(other);
+    }
+
+    intrusive_list& operator=(intrusive_list&& other) noexcept {
+      if (this != &other) {
+        clear();
+        _take(other);
+      }
+      return *this;
+    }
+
+    // Unlinks whatever is still in the list; the objects themselves live on
+    ~intrusive_list() {
+      clear();
+      m_root.m_next = nullptr;
+      m_root.m_prev = nullptr;
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+    [[nodiscard]] size_t max_size() const noexcept { return std::numeric_limits<size_t>::max(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] _T& front() noexcept { return *begin(); }
+    [[nodiscard]] const _T& front() const noexcept { return *begin(); }
+
+    [[nodiscard]] _T& back() noexcept { return *(end() - 1); }
+    [[nodiscard]] const _T& back() const noexcept { return *(end() - 1); }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(m_root.m_next); }
+    [[nodiscard]] iterator end() noexcept { return iterator(&m_root); }
+    [[nodiscard]] const_iterator begin() const noexcept { return const_iterator(m_root.m_next); }
+    [[nodiscard]] const_iterator end() const noexcept { return const_iterator(_root()); }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    [[nodiscard]] reverse_const_iterator crbegin() const noexcept { return reverse_const_iterator(cend()); }
+    [[nodiscard]] reverse_const_iterator crend() const noexcept { return reverse_const_iterator(cbegin()); }
+
+    // Iterator to an object known to be in this list
+    [[nodiscard]] iterator iterator_to(_T& item) noexcept { return iterator(&(item.*_Hook)); }
+    [[nodiscard]] const_iterator iterator_to(const _T& item) const noexcept {
+      return const_iterator(const_cast<list_hook*>(&(item.*_Hook)));
+    }
+
+    void push_back(_T& item) noexcept {
+      _link(&(item.*_Hook), &m_root);
+    }
+
+    void push_front(_T& item) noexcept {
+      _link(&(item.*_Hook), m_root.m_next);
+    }
+
+    _T& pop_back() noexcept {
+      assert(m_size > 0);
+      _T& item = back();
+      _unlink(&(item.*_Hook));
+      return item;
+    }
+
+    _T& pop_front() noexcept {
+      assert(m_size > 0);
+      _T& item = front();
+      _unlink(&(item.*_Hook));
+      return item;
+    }
+
+    iterator insert(const_iterator pos, _T& item) noexcept {
+      _link(&(item.*_Hook), pos.m_hook);
+      return iterator(&(item.*_Hook));
+    }
+
+    iterator erase(const_iterator pos) noexcept {
+      list_hook* next = pos.m_hook->m_next;
+      _unlink(pos.m_hook);
+      return iterator(next);
+    }
+
+    iterator erase(const_iterator _beg, const_iterator _end) noexcept {
+      while (_beg != _end) {
+        _beg = erase(_beg);
+      }
+      return iterator(_end.m_hook);
+    }
+
+    // Unlinks an object known to be in this list
+    void erase(_T& item) noexcept {
+      _unlink(&(item.*_Hook));
+    }
+
+    void clear() noexcept {
+      list_hook* hook = m_root.m_next;
+      while (hook != &m_root) {
+        list_hook* next = hook->m_next;
+        hook->m_next = nullptr;
+        hook->m_prev = nullptr;
+        hook = next;
+      }
+      m_root.m_next = &m_root;
+      m_root.m_prev = &m_root;
+      m_size = 0;
+    }
+
+    // Moves the object at it from other before pos in O(1)
+    void splice(const_iterator pos, intrusive_list& other, const_iterator it) noexcept {
+      other._unlink(it.m_hook);
+      _link(it.m_hook, pos.m_hook);
+    }
+
+  private:
+    [[nodiscard]] list_hook* _root() const noexcept { return const_cast<list_hook*>(&m_root); }
+
+    [[nodiscard]] static _T* _owner(list_hook* hook) noexcept {
+      constexpr std::ptrdiff_t offset = _detail::_hook_offset<_T, _Hook>;
+      static_assert(offset >= 0, "JMK::intrusive_list hook must be a member of _T");
+      return reinterpret_cast<_T*>(reinterpret_cast<std::byte*>(hook) - offset);
+    }
+
+    void _link(list_hook* hook, list_hook* at) noexcept {
+      assert(!hook->is_linked());
+      list_hook* prev = at->m_prev;
+      hook->m_prev = prev;
+      hook->m_next = at;
+      prev->m_next = hook;
+      at->m_prev = hook;
+      m_size += 1;
+    }
+
+    void _unlink(list_hook* hook) noexcept {
+      assert(hook != &m_root && hook->is_linked());
+      hook->m_prev->m_next = hook->m_next;
+      hook->m_next->m_prev = hook->m_prev;
+      hook->m_next = nullptr;
+      hook->m_prev = nullptr;
+      m_size -= 1;
+    }
+
+    void _take(intrusive_list& other) noexcept {
+      if (other.empty()) {
+        return;
+      }
+      m_root.m_next = other.m_root.m_next;
+      m_root.m_prev = other.m_root.m_prev;
+      m_size = other.m_size;
+      // The first and last objects still link to the other list's root
+      m_root.m_next->m_prev = &m_root;
+      m_root.m_prev->m_next = &m_root;
+      other.m_root.m_next = &other.m_root;
+      other.m_root.m_prev = &other.m_root;
+      other.m_size = 0;
+    }
+
+    list_hook m_root;
+    size_t m_size = 0;
+  };
+
+}
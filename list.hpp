@@ -2,17 +2,43 @@
 
 #include <cassert>
 #include <algorithm>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include "allocator.hpp"
+#include "instrument.hpp"
 
 namespace JMK {
 
   template <typename _T>
   class list {
-    struct _node {
-      _node* m_next;
-      _node* m_prev;
+  public:
+    class node_pool;
+
+  private:
+    // The links alone, which is all the sentinel has. Nodes are only ever
+    // linked and walked as _links, so the sentinel inside the list is never
+    // accessed through a type it doesn't have.
+    struct _links {
+      _links* m_next;
+      _links* m_prev;
+
+      [[nodiscard]] _T& item() noexcept;
+    };
+
+    // Each node remembers the pool it came from, so it can be relinked into
+    // any other list and still be freed to the right pool
+    struct _node : _links {
+      template <typename ... _Args>
+      _node(node_pool* owner, _Args&& ... args) : _links{ nullptr, nullptr }, m_owner(owner),
+        m_item(std::forward<_Args>(args)...) {}
+
+      node_pool* m_owner;
       _T m_item;
     };
 
@@ -28,9 +54,9 @@ namespace JMK {
       using pointer = value_type*;
       using reference = value_type&;
 
-      iterator() = delete;
+      iterator() noexcept = default;
       iterator(const iterator&) = default;
-      iterator(_node* value) noexcept : m_value(value) {}
+      iterator(_links* value) noexcept : m_value(value) {}
 
       [[nodiscard]] iterator operator+(difference_type i) const noexcept {
         if (i < 0) {
@@ -49,7 +75,7 @@ namespace JMK {
         return *this;
       }
 
-      iterator& operator++(int) noexcept {
+      iterator operator++(int) noexcept {
         iterator copy = *this;
         m_value = m_value->m_next;
         return copy;
@@ -72,18 +98,18 @@ namespace JMK {
         return *this;
       }
 
-      iterator& operator--(int) noexcept {
+      iterator operator--(int) noexcept {
         iterator copy = *this;
         m_value = m_value->m_prev;
         return copy;
       }
 
-      [[nodiscard]] reference operator*() noexcept {
-        return m_value->m_item;
+      [[nodiscard]] reference operator*() const noexcept {
+        return m_value->item();
       }
 
-      [[nodiscard]] pointer operator->() noexcept {
-        return &m_value->m_item;
+      [[nodiscard]] pointer operator->() const noexcept {
+        return &m_value->item();
       }
 
       iterator& operator=(const iterator&) = default;
@@ -92,22 +118,22 @@ namespace JMK {
       [[nodiscard]] std::strong_ordering operator<=>(const iterator& other) const& = default;
 
     private:
-      _node* m_value;
+      _links* m_value = nullptr;
     };
 
     class const_iterator {
       friend class JMK::list<_T>;
 
     public:
-      using iterator_category = std::contiguous_iterator_tag;
-      using value_type = std::remove_reference_t<const _T>;
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = std::remove_reference_t<_T>;
       using difference_type = std::ptrdiff_t;
-      using pointer = value_type*;
-      using reference = value_type&;
+      using pointer = const value_type*;
+      using reference = const value_type&;
 
-      const_iterator() = delete;
+      const_iterator() noexcept = default;
       const_iterator(const const_iterator&) = default;
-      const_iterator(_node* value) noexcept : m_value(value) {}
+      const_iterator(_links* value) noexcept : m_value(value) {}
 
       [[nodiscard]] const_iterator operator+(difference_type i) const noexcept {
         if (i < 0) {
@@ -118,7 +144,7 @@ namespace JMK {
           copy.m_value = copy.m_value->m_next;
           i -= 1;
         }
-        return *copy;
+        return copy;
       }
 
       const_iterator& operator++() noexcept {
@@ -126,7 +152,7 @@ namespace JMK {
         return *this;
       }
 
-      const_iterator& operator++(int) noexcept {
+      const_iterator operator++(int) noexcept {
         const_iterator copy = *this;
         m_value = m_value->m_next;
         return copy;
@@ -141,7 +167,7 @@ namespace JMK {
           copy.m_value = copy.m_value->m_prev;
           i -= 1;
         }
-        return *copy;
+        return copy;
       }
 
       const_iterator& operator--() noexcept {
@@ -149,18 +175,18 @@ namespace JMK {
         return *this;
       }
 
-      const_iterator& operator--(int) noexcept {
+      const_iterator operator--(int) noexcept {
         const_iterator copy = *this;
         m_value = m_value->m_prev;
         return copy;
       }
 
-      [[nodiscard]] reference operator*() noexcept {
-        return m_value->m_item;
+      [[nodiscard]] reference operator*() const noexcept {
+        return m_value->item();
       }
 
-      [[nodiscard]] pointer operator->() noexcept {
-        return &m_value->m_item;
+      [[nodiscard]] pointer operator->() const noexcept {
+        return &m_value->item();
       }
 
       const_iterator& operator=(const const_iterator&) = default;
@@ -169,45 +195,99 @@ namespace JMK {
       [[nodiscard]] std::strong_ordering operator<=>(const const_iterator& other) const& = default;
 
     private:
-      _node* m_value;
+      _links* m_value = nullptr;
     };
 
     using reverse_iterator = std::reverse_iterator<iterator>;
     using reverse_const_iterator = std::reverse_iterator<const_iterator>;
 
-    list() noexcept(std::is_trivially_constructible_v<_T>) : list(_T(), 0) {}
+    // Slab allocator for list nodes. Nodes are carved out of contiguous chunks
+    // and erased nodes are recycled through a free list, so a pool can be shared
+    // between lists of the same type that live on the same thread. Lists that
+    // took nodes from each other through splice or merge share their pools
+    // the same way.
+    class node_pool : public JMK::pool, public std::enable_shared_from_this<node_pool> {
+      friend class JMK::list<_T>;
 
-    template <typename _U>
-    list(const list<_U>& other) noexcept(std::is_trivially_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>&&
-      std::is_trivially_copy_assignable_v<_U>&&
-      std::is_trivially_constructible_v<_U>) : m_end(nullptr), m_size(0) {
-      m_begin = _sentinel_node();
+    public:
+      explicit node_pool(size_t nodes_per_slab = JMK::pool::default_blocks_per_chunk) noexcept
+        : JMK::pool(sizeof(_node), nodes_per_slab) {}
+
+    private:
+      // Live nodes keep their pool alive in whichever list they are linked:
+      // the first one takes a reference to the pool and freeing the last one
+      // drops it, so relinking a node never touches the count
+      [[nodiscard]] void* _allocate_node() {
+        void* mem = allocate(sizeof(_node), alignof(_node));
+        if (m_live_nodes == 0) {
+          m_self = this->shared_from_this();
+        }
+        m_live_nodes += 1;
+        return mem;
+      }
+
+      void _deallocate_node(void* mem) noexcept {
+        deallocate(mem, sizeof(_node), alignof(_node));
+        if (--m_live_nodes == 0) {
+          // May destroy this pool, so it has to be the last thing done here
+          std::shared_ptr<node_pool> self = std::move(m_self);
+        }
+      }
+
+      size_t m_live_nodes = 0;
+      std::shared_ptr<node_pool> m_self;
+    };
+
+    list() noexcept {}
+
+    explicit list(std::shared_ptr<node_pool> pool) noexcept : m_pool(std::move(pool)) {}
+
+    list(const list& other) {
       _copy_from_list(other);
     }
 
+    list(list&& other) noexcept {
+      _move_from_list(std::move(other));
+    }
+
     template <typename _U>
-    list(list<_U>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    list(const list<_U>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
-      std::is_trivially_move_assignable_v<_U>&&
-      std::is_trivially_constructible_v<_U>) : m_end(nullptr), m_size(0) {
-      m_begin = _sentinel_node();
-      _move_from_list(std::move(other));
+      std::is_trivially_copy_assignable_v<_U>&&
+      std::is_trivially_constructible_v<_U>) {
+      _copy_from_list(other);
     }
 
     list(_T _fill, size_t size) noexcept(std::is_trivially_copy_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) : m_end(nullptr), m_size(0) {
-      m_begin = _sentinel_node();
+      std::is_trivially_constructible_v<_T>) {
       resize(size);
       fill(_fill);
     }
 
     list(std::initializer_list<_T> list) noexcept(std::is_trivially_copy_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) : m_end(nullptr), m_size(0) {
-      m_begin = _sentinel_node();
+      std::is_trivially_constructible_v<_T>) {
       _init_from_list(list);
     }
 
+    ~list() {
+      clear();
+    }
+
+    list& operator=(const list& other) {
+      if (this != &other) {
+        _copy_from_list(other);
+      }
+      return *this;
+    }
+
+    list& operator=(list&& other) noexcept {
+      if (this != &other) {
+        clear();
+        _move_from_list(std::move(other));
+      }
+      return *this;
+    }
+
     [[nodiscard]] size_t size() const noexcept { return m_size; }
     [[nodiscard]] size_t max_size() const noexcept { return std::numeric_limits<size_t>::max(); }
 
@@ -237,61 +317,70 @@ namespace JMK {
     [[nodiscard]] _T& back() noexcept { return *(end() - 1); }
     [[nodiscard]] const _T& back() const noexcept { return *(end() - 1); }
 
+    // Node allocations and frees of this list, and its peak length; all zero
+    // unless built with JMK_INSTRUMENT
+    [[nodiscard]] JMK::instrument::counters instrumentation() const noexcept { return m_probe.get(); }
+
+    // Returns the node pool backing this list, creating it on first use
+    [[nodiscard]] const std::shared_ptr<node_pool>& get_node_pool() {
+      if (!m_pool) {
+        m_pool = std::make_shared<node_pool>();
+      }
+      return m_pool;
+    }
+
     void resize(size_t new_size) {
       _resize_impl(new_size);
     }
 
-    [[nodiscard]] iterator begin() noexcept { return m_begin; }
+    [[nodiscard]] iterator begin() noexcept { return m_root.m_next; }
     [[nodiscard]] iterator end() noexcept { return _sentinel_node(); }
-    [[nodiscard]] const_iterator begin() const noexcept { return m_begin; }
+    [[nodiscard]] const_iterator begin() const noexcept { return m_root.m_next; }
     [[nodiscard]] const_iterator end() const noexcept { return _sentinel_node(); }
 
-    [[nodiscard]] const_iterator cbegin() const noexcept { return m_begin; }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return m_root.m_next; }
     [[nodiscard]] const_iterator cend() const noexcept { return _sentinel_node(); }
 
-    [[nodiscard]] reverse_iterator rbegin() noexcept { return _sentinel_node(); }
-    [[nodiscard]] reverse_iterator rend() noexcept { return m_begin; }
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
 
-    [[nodiscard]] reverse_iterator crbegin() const noexcept { return _sentinel_node(); }
-    [[nodiscard]] reverse_iterator crend() const noexcept { return m_begin; }
+    [[nodiscard]] reverse_const_iterator crbegin() const noexcept { return reverse_const_iterator(cend()); }
+    [[nodiscard]] reverse_const_iterator crend() const noexcept { return reverse_const_iterator(cbegin()); }
 
     template <typename ... _Args>
     void emplace_back(_Args&& ... args) noexcept(std::is_trivially_constructible_v<_T>) {
       emplace(end(), std::forward<_Args>(args)...);
-      m_size += 1;
     }
 
     void push_back(const _T& value) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) {
-      insert(end(), _T(value));
-      m_size += 1;
+      insert(end(), value);
     }
 
     _T pop_back() noexcept(std::is_trivially_copy_assignable_v<_T>&& std::is_trivially_constructible_v<_T>) {
       assert(m_size > 0);
-      return erase(end());
+      _T value = std::move(back());
+      erase(end() - 1);
+      return value;
     }
 
     template <typename ... _Args>
     iterator emplace(iterator pos, _Args&& ... args) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_constructible_v<_T>) {
-      insert(pos, _T(std::forward<_Args>(args)...));
-      m_size += 1;
-      return pos;
+      _links* new_node = _create_node(std::forward<_Args>(args)...);
+      _insert_node(new_node, pos.m_value);
+      return iterator(new_node);
     }
 
     iterator insert(iterator pos, const _T& value) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) {
-      _node* new_node = new _node;
-      new_node->m_item = value;
-      _insert_node(new_node, pos.m_value);
-      return iterator(new_node);
+      return emplace(pos, value);
     }
 
     iterator erase(iterator pos) noexcept(std::is_trivially_destructible_v<_T>) {
-      _node* next = pos.m_value->m_next;
+      _links* next = pos.m_value->m_next;
       _remove_node(pos.m_value);
-      delete pos.m_value;
+      _destroy_node(pos.m_value);
       return iterator(next);
     }
 
@@ -318,129 +407,204 @@ namespace JMK {
       fill(_T());
     }
 
-  private:
-    template <typename _U>
-    void _copy_from_list(const list<_U>& other) {
-      clear();
-
-      _node* other_node = other.m_begin;
+    // Splicing, merging and sorting only relink nodes, whichever pools the
+    // lists allocate from. Every node keeps its own pool alive.
 
-      for (_U& item : other) {
-        _node* new_node = new _node;
-        new_node->m_item = _T(item);
-        _append_node(new_node);
+    // Moves every element of other before pos
+    void splice(iterator pos, list& other) {
+      if (this != &other && !other.empty()) {
+        _splice_range(pos.m_value, other, other.m_root.m_next, other._sentinel_node(), other.m_size);
       }
     }
 
-    template <typename _U>
-    void _move_from_list(list<_U>&& other) {
-      m_begin = other.m_begin;
-      m_end = other.m_end;
-      m_size = other.m_size;
-      other.m_begin = other._sentinel_node();
-      other.m_end = nullptr;
-      other.m_size = 0;
+    void splice(iterator pos, list&& other) {
+      splice(pos, other);
     }
 
-    void _init_from_list(std::initializer_list<_T> list) {
-      clear();
-
-      for (_T item : list) {
-        _node* new_node = new _node;
-        new_node->m_item = item;
-        _append_node(new_node);
+    // Moves the element at it from other before pos
+    void splice(iterator pos, list& other, iterator it) {
+      if (pos.m_value == it.m_value || pos.m_value == it.m_value->m_next) {
+        return;
       }
+      _splice_range(pos.m_value, other, it.m_value, it.m_value->m_next, 1);
     }
 
-    void _resize_impl(size_t new_size) {
-      if (new_size == 0) {
-        m_begin = _sentinel_node();
-        m_end = nullptr;
-        m_size = 0;
+    void splice(iterator pos, list&& other, iterator it) {
+      splice(pos, other, it);
+    }
+
+    // Moves [first, last) from other before pos. Constant time within a list,
+    // linear in the range length between lists since it has to be counted.
+    void splice(iterator pos, list& other, iterator first, iterator last) {
+      if (first == last) {
         return;
       }
+      size_t count = this == &other ? 0 : static_cast<size_t>(std::distance(first, last));
+      _splice_range(pos.m_value, other, first.m_value, last.m_value, count);
+    }
 
-      _node* node = m_begin;
-      if (m_begin == _sentinel_node()) {
-        m_begin = new _node;
-        m_begin->m_prev = nullptr;
-        m_begin->m_next = (_node*)&m_begin;
-        m_begin->m_item = _T();
-        m_end = m_begin;
-        node = m_begin;
-        new_size -= 1;
-      }
+    void splice(iterator pos, list&& other, iterator first, iterator last) {
+      splice(pos, other, first, last);
+    }
 
-      size_t i = 0;
-      while (i < new_size) {
-        if (node->m_next) {
-          node = node->m_next;
-          i += 1;
-          continue;
+    // Merges the sorted other into this sorted list. Stable: on ties the
+    // elements already in this list come first.
+    template <typename _Compare = std::less<>>
+    void merge(list& other, _Compare comp = _Compare()) {
+      if (this == &other || other.empty()) {
+        return;
+      }
+      _links* first1 = m_root.m_next;
+      _links* first2 = other.m_root.m_next;
+      _links* last2 = other._sentinel_node();
+      while (first1 != _sentinel_node() && first2 != last2) {
+        if (comp(first2->item(), first1->item())) {
+          _links* next = first2->m_next;
+          other._remove_node(first2);
+          _insert_node(first2, first1);
+          first2 = next;
         }
-        _node* new_node = new _node;
-        new_node->m_prev = node;
-        node->m_next = new_node;
-        new_node->m_item = _T();
-        node = new_node;
-        m_end = new_node;
-      }
-
-      if (node->m_next) {
-        _node* rem = m_end;
-        while (rem != node) {
-          _node* prev = rem->m_prev;
-          delete rem;
-          rem = prev;
+        else {
+          first1 = first1->m_next;
         }
       }
+      if (first2 != last2) {
+        _transfer(_sentinel_node(), other, first2, last2, other.m_size);
+      }
+      m_probe.on_capacity(m_size);
+    }
 
-      m_size = new_size;
+    template <typename _Compare = std::less<>>
+    void merge(list&& other, _Compare comp = _Compare()) {
+      merge(other, comp);
     }
 
-    void _append_node(_node* n) {
-      if (m_begin == _sentinel_node()) {
-        m_begin = m_end = n;
-        m_begin->m_next = _sentinel_node();
-        m_begin->m_prev = nullptr;
-        m_size = 1;
+    // Stable bottom-up merge sort. Runs of doubling length are kept in bins
+    // as null terminated chains, so sorting needs no allocation and only the
+    // prev links are rebuilt at the end.
+    template <typename _Compare = std::less<>>
+    void sort(_Compare comp = _Compare()) {
+      if (m_size < 2) {
         return;
       }
-      m_end->m_next = n;
-      n->m_prev = m_end;
-      n->m_next = _sentinel_node();
-      m_end = n;
-      m_size += 1;
+      _links* bins[64] = {};
+      size_t used = 0;
+      _links* n = m_root.m_next;
+      while (n != _sentinel_node()) {
+        _links* carry = n;
+        n = n->m_next;
+        carry->m_next = nullptr;
+
+        size_t i = 0;
+        for (; i < used && bins[i]; ++i) {
+          carry = _merge_chains(bins[i], carry, comp);
+          bins[i] = nullptr;
+        }
+        bins[i] = carry;
+        used = std::max(used, i + 1);
+      }
+
+      _links* result = nullptr;
+      for (size_t i = 0; i < used; ++i) {
+        if (bins[i]) {
+          result = result ? _merge_chains(bins[i], result, comp) : bins[i];
+        }
+      }
+
+      _links* prev = _sentinel_node();
+      for (n = result; n; n = n->m_next) {
+        n->m_prev = prev;
+        prev->m_next = n;
+        prev = n;
+      }
+      prev->m_next = _sentinel_node();
+      m_root.m_prev = prev;
     }
 
-    void _prepend_node(_node* n) {
-      if (m_begin == _sentinel_node()) {
-        m_begin = m_end = n;
-        m_begin->m_next = _sentinel_node();
-        m_begin->m_prev = nullptr;
-        m_size = 1;
-        return;
+  private:
+    template <typename _U>
+    void _copy_from_list(const list<_U>& other) {
+      clear();
+
+      for (const _U& item : other) {
+        _append_node(_create_node(item));
       }
-      m_begin->m_prev = n;
-      n->m_next = m_begin;
-      n->m_prev = nullptr;
-      m_begin = n;
-      m_size += 1;
     }
 
-    void _insert_node(_node* n, _node* at) {
-      if (at == _sentinel_node()) {
-        _append_node(n);
+    void _move_from_list(list&& other) noexcept {
+      m_probe = std::move(other.m_probe);
+      if (other.empty()) {
         return;
       }
+      m_root.m_next = other.m_root.m_next;
+      m_root.m_prev = other.m_root.m_prev;
+      m_size = other.m_size;
+      m_pool = std::move(other.m_pool);
 
-      if (at == m_begin) {
-        _prepend_node(n);
-        return;
+      // The first and last nodes still link to the other list's sentinel
+      m_root.m_next->m_prev = _sentinel_node();
+      m_root.m_prev->m_next = _sentinel_node();
+
+      other.m_root.m_next = other._sentinel_node();
+      other.m_root.m_prev = other._sentinel_node();
+      other.m_size = 0;
+    }
+
+    void _init_from_list(std::initializer_list<_T> list) {
+      clear();
+
+      for (const _T& item : list) {
+        _append_node(_create_node(item));
       }
+    }
 
-      _node* next = at;
-      _node* prev = at->m_prev;
+    void _resize_impl(size_t new_size) {
+      while (m_size > new_size) {
+        erase(end() - 1);
+      }
+      while (m_size < new_size) {
+        _append_node(_create_node());
+      }
+    }
+
+    template <typename ... _Args>
+    _node* _create_node(_Args&& ... args) {
+      node_pool* pool = get_node_pool().get();
+      void* mem = pool->_allocate_node();
+      _node* n;
+      try {
+        n = new(mem) _node(pool, std::forward<_Args>(args)...);
+      }
+      catch (...) {
+        pool->_deallocate_node(mem);
+        throw;
+      }
+      m_probe.on_allocate(sizeof(_node));
+      m_probe.on_capacity(m_size + 1);
+      return n;
+    }
+
+    void _destroy_node(_links* l) noexcept {
+      _node* n = static_cast<_node*>(l);
+      node_pool* owner = n->m_owner;
+      n->~_node();
+      m_probe.on_deallocate(sizeof(_node));
+      owner->_deallocate_node(n);
+    }
+
+    void _append_node(_links* n) {
+      _insert_node(n, _sentinel_node());
+    }
+
+    void _prepend_node(_links* n) {
+      _insert_node(n, m_root.m_next);
+    }
+
+    // The sentinel's links are the list's first and last nodes, so the chain
+    // is circular and no end needs to be special cased
+    void _insert_node(_links* n, _links* at) {
+      _links* next = at;
+      _links* prev = at->m_prev;
 
       n->m_prev = prev;
       n->m_next = next;
@@ -450,22 +614,72 @@ namespace JMK {
       m_size += 1;
     }
 
-    void _remove_node(_node* at) {
+    void _remove_node(_links* at) {
       if (at == _sentinel_node()) {
         return;
       }
-      _node* prev = at->m_prev;
-      _node* next = at->m_next;
+      _links* prev = at->m_prev;
+      _links* next = at->m_next;
       prev->m_next = next;
       next->m_prev = prev;
       m_size -= 1;
     }
 
-    _node* _sentinel_node() const noexcept { return (_node*)&m_begin; }
+    void _splice_range(_links* at, list& other, _links* first, _links* last, size_t count) {
+      _transfer(at, other, first, last, count);
+      m_probe.on_capacity(m_size);
+    }
+
+    // Relinks [first, last) of other before at. count is the length of the
+    // range and only matters when other is a different list.
+    void _transfer(_links* at, list& other, _links* first, _links* last, size_t count) noexcept {
+      _links* tail = last->m_prev;
+      first->m_prev->m_next = last;
+      last->m_prev = first->m_prev;
+
+      _links* prev = at->m_prev;
+      prev->m_next = first;
+      first->m_prev = prev;
+      tail->m_next = at;
+      at->m_prev = tail;
+
+      if (this != &other) {
+        other.m_size -= count;
+        m_size += count;
+      }
+    }
+
+    // Merges two null terminated chains, taking from a on ties
+    template <typename _Compare>
+    static _links* _merge_chains(_links* a, _links* b, _Compare& comp) {
+      _links* head = nullptr;
+      _links** tail = &head;
+      while (a && b) {
+        if (comp(b->item(), a->item())) {
+          *tail = b;
+          b = b->m_next;
+        }
+        else {
+          *tail = a;
+          a = a->m_next;
+        }
+        tail = &(*tail)->m_next;
+      }
+      *tail = a ? a : b;
+      return head;
+    }
+
+    _links* _sentinel_node() const noexcept { return const_cast<_links*>(&m_root); }
 
-    _node* m_begin;
-    _node* m_end;
-    size_t m_size;
+    _links m_root{ _sentinel_node(), _sentinel_node() };
+    size_t m_size = 0;
+    std::shared_ptr<node_pool> m_pool;
+    [[no_unique_address]] JMK::instrument::probe<list> m_probe;
   };
 
-}
\ No newline at end of file
+  template <typename _T>
+  _T& list<_T>::_links::item() noexcept {
+    return static_cast<_node*>(this)->m_item;
+  }
+
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "backoff.hpp"
+#include "traits.hpp"
+
+namespace JMK {
+
+  // Bounded multi-producer/multi-consumer queue (Vyukov). Every cell of the
+  // ring carries a sequence number that tells producers and consumers whose
+  // turn it is, so each operation is one CAS on the shared position plus
+  // uncontended work on its own cell.
+  template <typename _T, size_t _N>
+  class mpmc_queue {
+    // A producer whose element throws while moving in after its claim still
+    // has to publish the cell; it marks it as a hole for consumers to skip.
+    // Only element types with a throwing move constructor can leave holes.
+    static constexpr bool _may_leave_holes = !std::is_nothrow_move_constructible_v<_T>;
+
+    struct _cell {
+      std::atomic<size_t> m_sequence;
+      bool m_hole = false;
+      alignas(_T) std::byte m_storage[sizeof(_T)];
+
+      [[nodiscard]] _T* item() noexcept { return std::launder(reinterpret_cast<_T*>(m_storage)); }
+    };
+
+    // Destroys the element of a claimed cell and hands the cell back to
+    // producers, also when moving the element out throws
+    struct _release {
+      ~_release() {
+        std::destroy_at(m_cell->item());
+        m_queue->_publish(m_cell, m_sequence);
+      }
+
+      mpmc_queue* m_queue;
+      _cell* m_cell;
+      size_t m_sequence;
+    };
+
+  public:
+    static_assert(_N >= 2 && (_N & (_N - 1)) == 0, "JMK::mpmc_queue capacity must be a power of two");
+
+    mpmc_queue() noexcept {
+      for (size_t i = 0; i < _N; ++i) {
+        m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    // Must not race with other operations, so every claimed cell is published
+    ~mpmc_queue() {
+      if constexpr (!std::is_trivially_destructible_v<_T>) {
+        size_t end = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (size_t pos = m_dequeue_pos.load(std::memory_order_relaxed); pos != end; ++pos) {
+          _cell& cell = m_cells[pos & (_N - 1)];
+          if (!cell.m_hole) {
+            std::destroy_at(cell.item());
+          }
+        }
+      }
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() noexcept { return _N; }
+    [[nodiscard]] static constexpr size_t max_size() noexcept { return _N; }
+
+    // Approximate when called while other threads are active
+    [[nodiscard]] size_t size() const noexcept {
+      size_t tail = m_enqueue_pos.load(std::memory_order_acquire);
+      size_t head = m_dequeue_pos.load(std::memory_order_acquire);
+      return tail > head ? tail - head : 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    // Elements that cannot be built in place without throwing are built
+    // before a cell is claimed: once claimed, a cell must be published or
+    // the ring stalls behind it. On a full queue the built element is dropped.
+    template <typename ... _Args>
+    bool try_emplace(_Args&& ... args) noexcept(std::is_nothrow_constructible_v<_T, _Args...>) {
+      if constexpr (std::is_nothrow_constructible_v<_T, _Args...>) {
+        return _push(std::forward<_Args>(args)...);
+      }
+      else {
+        _T value(std::forward<_Args>(args)...);
+        return _push(std::move(value));
+      }
+    }
+
+    bool try_enqueue(const _T& item) noexcept(std::is_nothrow_copy_constructible_v<_T>) {
+      return try_emplace(item);
+    }
+
+    // Leaves item untouched when the queue is full
+    bool try_enqueue(_T&& item) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      return _push(std::move(item));
+    }
+
+    // The element leaves the queue even if assigning it to out throws
+    bool try_dequeue(_T& out) noexcept(std::is_nothrow_move_assignable_v<_T>) {
+      size_t pos;
+      _cell* cell = _pop(pos);
+      if (cell == nullptr) {
+        return false;
+      }
+      _release release{ this, cell, pos + _N };
+      out = std::move(*cell->item());
+      return true;
+    }
+
+    // Blocking variants spin, then yield, then park until the cell they are
+    // waiting on changes hands
+    void enqueue(const _T& item) {
+      _T copy(item);
+      enqueue(std::move(copy));
+    }
+
+    void enqueue(_T&& item) {
+      JMK::backoff wait;
+      while (!try_enqueue(std::move(item))) {
+        if (!wait.is_completed()) {
+          wait.snooze();
+          continue;
+        }
+        _park(m_enqueue_pos, 0);
+      }
+    }
+
+    _T dequeue() {
+      JMK::backoff wait;
+      for (;;) {
+        size_t pos;
+        if (_cell* cell = _pop(pos)) {
+          _release release{ this, cell, pos + _N };
+          return std::move(*cell->item());
+        }
+        if (!wait.is_completed()) {
+          wait.snooze();
+          continue;
+        }
+        _park(m_dequeue_pos, 1);
+      }
+    }
+
+  private:
+    template <typename ... _Args>
+    bool _push(_Args&& ... args) noexcept(std::is_nothrow_constructible_v<_T, _Args...>) {
+      size_t pos;
+      _cell* cell = _claim(m_enqueue_pos, 0, pos);
+      if (cell == nullptr) {
+        return false;
+      }
+      if constexpr (std::is_nothrow_constructible_v<_T, _Args...>) {
+        ::new(static_cast<void*>(cell->m_storage)) _T(std::forward<_Args>(args)...);
+      }
+      else {
+        try {
+          ::new(static_cast<void*>(cell->m_storage)) _T(std::forward<_Args>(args)...);
+        }
+        catch (...) {
+          cell->m_hole = true;
+          _publish(cell, pos + 1);
+          throw;
+        }
+      }
+      _publish(cell, pos + 1);
+      return true;
+    }
+
+    // Claims the next cell holding an element, handing back any holes on
+    // the way, or returns nullptr if the queue is empty
+    _cell* _pop(size_t& pos) noexcept {
+      for (;;) {
+        _cell* cell = _claim(m_dequeue_pos, 1, pos);
+        if constexpr (_may_leave_holes) {
+          if (cell != nullptr && cell->m_hole) {
+            cell->m_hole = false;
+            _publish(cell, pos + _N);
+            continue;
+          }
+        }
+        return cell;
+      }
+    }
+
+    // Claims the cell at the current position once its sequence equals
+    // pos + lag, or returns nullptr if the queue is full (or empty)
+    _cell* _claim(std::atomic<size_t>& position, size_t lag, size_t& pos) noexcept {
+      JMK::backoff contention;
+      pos = position.load(std::memory_order_relaxed);
+      for (;;) {
+        _cell* cell = &m_cells[pos & (_N - 1)];
+        size_t seq = cell->m_sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + lag);
+        if (diff == 0) {
+          if (position.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            return cell;
+          }
+          contention.spin();
+        }
+        else if (diff < 0) {
+          return nullptr;
+        }
+        else {
+          pos = position.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    // The sequence store is seq_cst so it cannot pass the parked check below,
+    // which pairs with the increment in _park to rule out lost wakeups
+    void _publish(_cell* cell, size_t sequence) noexcept {
+      cell->m_sequence.store(sequence, std::memory_order_seq_cst);
+      if (m_parked.load(std::memory_order_seq_cst) != 0) {
+        cell->m_sequence.notify_all();
+      }
+    }
+
+    void _park(std::atomic<size_t>& position, size_t lag) noexcept {
+      size_t pos = position.load(std::memory_order_relaxed);
+      _cell* cell = &m_cells[pos & (_N - 1)];
+      size_t seq = cell->m_sequence.load(std::memory_order_acquire);
+      m_parked.fetch_add(1, std::memory_order_seq_cst);
+      if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + lag) < 0 &&
+        cell->m_sequence.load(std::memory_order_seq_cst) == seq) {
+        cell->m_sequence.wait(seq, std::memory_order_acquire);
+      }
+      m_parked.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    alignas(JMK::cache_line_size) std::atomic<size_t> m_enqueue_pos = 0;
+    alignas(JMK::cache_line_size) std::atomic<size_t> m_dequeue_pos = 0;
+    alignas(JMK::cache_line_size) std::atomic<uint32_t> m_parked = 0;
+    alignas(JMK::cache_line_size) _cell m_cells[_N];
+  };
+
+}
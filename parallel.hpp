@@ -0,0 +1,359 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "scheduler.hpp"
+#include "traits.hpp"
+#include "vector.hpp"
+
+namespace JMK::parallel {
+
+  // Anything exposing data() and size() over contiguous storage
+  template <typename _C>
+  concept contiguous_range = requires(_C& c) {
+    { c.data() } -> std::convertible_to<const void*>;
+    { c.size() } -> std::convertible_to<size_t>;
+  };
+
+  template <contiguous_range _C>
+  using element_t = std::remove_reference_t<decltype(*std::declval<_C&>().data())>;
+
+  // Pool used by the overloads that take no scheduler, started on first use
+  // with one worker per hardware thread
+  [[nodiscard]] inline JMK::scheduler& default_scheduler() {
+    static JMK::scheduler pool;
+    return pool;
+  }
+
+  namespace _detail {
+
+    // Splits [0, size) of an array starting at base into chunks of about
+    // grain elements whose inner boundaries fall on cache lines, so chunks
+    // written by different workers never share a line. A grain of zero picks
+    // about eight chunks per worker.
+    template <typename _T>
+    class _chunks {
+    public:
+      _chunks(const _T* base, size_t size, size_t grain, size_t workers) noexcept : m_size(size) {
+        constexpr size_t line = std::max<size_t>(JMK::cache_line_size / sizeof(_T), 1);
+        if (grain == 0) {
+          grain = size / (workers * 8);
+        }
+        m_grain = std::max<size_t>((grain + line - 1) / line * line, line);
+        if constexpr (JMK::cache_line_size % sizeof(_T) == 0) {
+          // Elements before the first line boundary form a chunk of their own
+          size_t misalignment = reinterpret_cast<uintptr_t>(base) % JMK::cache_line_size;
+          if (misalignment % sizeof(_T) == 0) {
+            m_head = std::min((JMK::cache_line_size - misalignment) % JMK::cache_line_size / sizeof(_T), size);
+          }
+        }
+        m_count = std::max<size_t>((m_head != 0) + (size - m_head + m_grain - 1) / m_grain, 1);
+      }
+
+      [[nodiscard]] size_t count() const noexcept { return m_count; }
+
+      [[nodiscard]] size_t begin(size_t chunk) const noexcept {
+        if (chunk == 0) {
+          return 0;
+        }
+        return std::min(m_size, m_head + (chunk - (m_head != 0)) * m_grain);
+      }
+
+      [[nodiscard]] size_t end(size_t chunk) const noexcept { return begin(chunk + 1); }
+
+    private:
+      size_t m_size;
+      size_t m_grain = 1;
+      size_t m_head = 0;
+      size_t m_count = 1;
+    };
+
+    // Per-chunk results, each on its own cache line
+    template <typename _V>
+    struct alignas(JMK::cache_line_size) _padded {
+      _V m_value;
+    };
+
+    // Calls fn(chunk, first, last) for every chunk, on the pool when there
+    // is more than one
+    template <typename _T, typename _Fn>
+    void _for_chunks(JMK::scheduler& pool, const _chunks<_T>& chunks, _Fn&& fn) {
+      if (chunks.count() == 1) {
+        fn(size_t(0), chunks.begin(0), chunks.end(0));
+        return;
+      }
+      pool.parallel_for(0, chunks.count(), 1, [&](size_t chunk) {
+        fn(chunk, chunks.begin(chunk), chunks.end(chunk));
+      });
+    }
+
+    // Folds every chunk but the last, which no scan needs the total of
+    template <typename _V, typename _T, typename _S, typename _Op>
+    JMK::vector<_padded<_V>> _chunk_totals(JMK::scheduler& pool, const _chunks<_T>& chunks, const _S* src, _Op& op) {
+      JMK::vector<_padded<_V>> totals;
+      totals.reserve(chunks.count());
+      for (size_t c = 0; c < chunks.count(); ++c) {
+        totals.push_back({ _V(src[chunks.begin(c)]) });
+      }
+      _for_chunks(pool, chunks, [&](size_t chunk, size_t first, size_t last) {
+        if (chunk + 1 == chunks.count()) {
+          return;
+        }
+        _V acc = src[first];
+        for (size_t i = first + 1; i < last; ++i) {
+          acc = op(std::move(acc), src[i]);
+        }
+        totals[chunk].m_value = std::move(acc);
+      });
+      return totals;
+    }
+
+    // Buckets smaller than this are not worth a parallel sort
+    inline constexpr size_t _min_bucket = 1 << 14;
+
+    // Samples taken per bucket when choosing splitters; more keeps bucket
+    // sizes closer together at the cost of a bigger sample sort
+    inline constexpr size_t _oversampling = 32;
+
+  }
+
+  // Calls fn(element) for every element
+  template <contiguous_range _C, typename _Fn>
+  void for_each(JMK::scheduler& pool, _C& range, _Fn fn, size_t grain = 0) {
+    auto* data = range.data();
+    _detail::_chunks chunks(data, range.size(), grain, pool.thread_count());
+    _detail::_for_chunks(pool, chunks, [&](size_t, size_t first, size_t last) {
+      for (size_t i = first; i < last; ++i) {
+        fn(data[i]);
+      }
+    });
+  }
+
+  // Stores fn(in[i]) in out[i]. out must hold at least in.size() elements and
+  // may be in itself.
+  template <contiguous_range _In, contiguous_range _Out, typename _Fn>
+  void transform(JMK::scheduler& pool, const _In& in, _Out& out, _Fn fn, size_t grain = 0) {
+    assert(out.size() >= in.size());
+    const auto* src = in.data();
+    auto* dst = out.data();
+    // Chunks follow the output so that written lines are never shared
+    _detail::_chunks chunks(dst, in.size(), grain, pool.thread_count());
+    _detail::_for_chunks(pool, chunks, [&](size_t, size_t first, size_t last) {
+      for (size_t i = first; i < last; ++i) {
+        dst[i] = fn(src[i]);
+      }
+    });
+  }
+
+  // Folds every element into init with op, which must be associative. Chunk
+  // results are combined left to right, so op need not be commutative.
+  template <contiguous_range _C, typename _V, typename _Op = std::plus<>>
+  [[nodiscard]] _V reduce(JMK::scheduler& pool, const _C& range, _V init, _Op op = {}, size_t grain = 0) {
+    const auto* data = range.data();
+    if (range.size() == 0) {
+      return init;
+    }
+    _detail::_chunks chunks(data, range.size(), grain, pool.thread_count());
+    JMK::vector<_detail::_padded<_V>> partial;
+    partial.reserve(chunks.count());
+    for (size_t c = 0; c < chunks.count(); ++c) {
+      partial.push_back({ init });
+    }
+    _detail::_for_chunks(pool, chunks, [&](size_t chunk, size_t first, size_t last) {
+      _V acc = data[first];
+      for (size_t i = first + 1; i < last; ++i) {
+        acc = op(std::move(acc), data[i]);
+      }
+      partial[chunk].m_value = std::move(acc);
+    });
+    for (size_t c = 0; c < chunks.count(); ++c) {
+      init = op(std::move(init), std::move(partial[c].m_value));
+    }
+    return init;
+  }
+
+  // out[i] = in[0] op ... op in[i]. Runs in two passes: chunk totals are
+  // folded in parallel, turned into running carries, and every chunk is then
+  // scanned from its carry. out may be in itself.
+  template <contiguous_range _In, contiguous_range _Out, typename _Op = std::plus<>>
+  void inclusive_scan(JMK::scheduler& pool, const _In& in, _Out& out, _Op op = {}, size_t grain = 0) {
+    using _V = std::remove_cv_t<element_t<_Out>>;
+    assert(out.size() >= in.size());
+    const auto* src = in.data();
+    auto* dst = out.data();
+    if (in.size() == 0) {
+      return;
+    }
+    _detail::_chunks chunks(dst, in.size(), grain, pool.thread_count());
+    auto carries = _detail::_chunk_totals<_V>(pool, chunks, src, op);
+    for (size_t c = 2; c < chunks.count(); ++c) {
+      carries[c - 1].m_value = op(carries[c - 2].m_value, std::move(carries[c - 1].m_value));
+    }
+    _detail::_for_chunks(pool, chunks, [&](size_t chunk, size_t first, size_t last) {
+      _V acc = chunk == 0 ? _V(src[first]) : op(carries[chunk - 1].m_value, src[first]);
+      dst[first] = acc;
+      for (size_t i = first + 1; i < last; ++i) {
+        acc = op(std::move(acc), src[i]);
+        dst[i] = acc;
+      }
+    });
+  }
+
+  // out[i] = init op in[0] op ... op in[i - 1]. out may be in itself.
+  template <contiguous_range _In, contiguous_range _Out, typename _V, typename _Op = std::plus<>>
+  void exclusive_scan(JMK::scheduler& pool, const _In& in, _Out& out, _V init, _Op op = {}, size_t grain = 0) {
+    assert(out.size() >= in.size());
+    const auto* src = in.data();
+    auto* dst = out.data();
+    if (in.size() == 0) {
+      return;
+    }
+    _detail::_chunks chunks(dst, in.size(), grain, pool.thread_count());
+    auto totals = _detail::_chunk_totals<_V>(pool, chunks, src, op);
+    // Shift the totals into carries: chunk c starts from init op totals[0..c)
+    for (size_t c = chunks.count() - 1; c > 0; --c) {
+      totals[c].m_value = std::move(totals[c - 1].m_value);
+    }
+    totals[0].m_value = init;
+    for (size_t c = 1; c < chunks.count(); ++c) {
+      totals[c].m_value = op(totals[c - 1].m_value, std::move(totals[c].m_value));
+    }
+    _detail::_for_chunks(pool, chunks, [&](size_t chunk, size_t first, size_t last) {
+      _V acc = std::move(totals[chunk].m_value);
+      for (size_t i = first; i < last; ++i) {
+        _V next = op(acc, src[i]);
+        dst[i] = std::move(acc);
+        acc = std::move(next);
+      }
+    });
+  }
+
+  // Sample sort: splitters chosen from an oversampled, sorted sample cut the
+  // range into one bucket per slice of work. Every block of the input counts
+  // and then scatters its elements into a scratch buffer by bucket, and the
+  // buckets are sorted and moved back independently. grain is the smallest
+  // bucket worth sorting on its own; with few elements, or element types
+  // that cannot be copied into splitters, this is std::sort. Not stable.
+  template <contiguous_range _C, typename _Cmp = std::less<>>
+  void sort(JMK::scheduler& pool, _C& range, _Cmp comp = {}, size_t grain = 0) {
+    using _T = std::remove_cv_t<element_t<_C>>;
+    _T* data = range.data();
+    size_t size = range.size();
+    size_t buckets = std::min(pool.thread_count() * 4, size / (grain ? grain : _detail::_min_bucket));
+    if constexpr (!std::is_copy_constructible_v<_T>) {
+      buckets = 0;
+    }
+    if (buckets < 2 || pool.thread_count() == 1) {
+      std::sort(data, data + size, comp);
+      return;
+    }
+
+    if constexpr (std::is_copy_constructible_v<_T>) {
+      // Evenly spaced samples, each jittered within its stride
+      size_t samples = std::min(buckets * _detail::_oversampling, size);
+      size_t stride = size / samples;
+      uint64_t seed = 0x9e3779b97f4a7c15ull ^ size;
+      JMK::vector<_T> sample;
+      sample.reserve(samples);
+      for (size_t s = 0; s < samples; ++s) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        sample.push_back(data[s * stride + seed % stride]);
+      }
+      std::sort(sample.data(), sample.data() + samples, comp);
+      JMK::vector<_T> splitters;
+      splitters.reserve(buckets - 1);
+      for (size_t b = 1; b < buckets; ++b) {
+        splitters.push_back(sample[b * samples / buckets]);
+      }
+      const _T* split_begin = splitters.data();
+      const _T* split_end = split_begin + splitters.size();
+
+      // Bucket of every element, and how many of each every block holds
+      _detail::_chunks blocks(data, size, 0, pool.thread_count());
+      JMK::vector<uint32_t> bucket_of;
+      bucket_of.resize_uninitialized(size);
+      JMK::vector<size_t> offsets(size_t(0), blocks.count() * buckets);
+      _detail::_for_chunks(pool, blocks, [&](size_t block, size_t first, size_t last) {
+        size_t* counts = offsets.data() + block * buckets;
+        for (size_t i = first; i < last; ++i) {
+          auto b = static_cast<uint32_t>(std::upper_bound(split_begin, split_end, data[i], comp) - split_begin);
+          bucket_of[i] = b;
+          counts[b] += 1;
+        }
+      });
+
+      // Bucket-major running sums turn counts into scatter positions
+      JMK::vector<size_t> bucket_begin(size_t(0), buckets + 1);
+      size_t position = 0;
+      for (size_t b = 0; b < buckets; ++b) {
+        bucket_begin[b] = position;
+        for (size_t block = 0; block < blocks.count(); ++block) {
+          size_t count = offsets[block * buckets + b];
+          offsets[block * buckets + b] = position;
+          position += count;
+        }
+      }
+      bucket_begin[buckets] = size;
+
+      std::allocator<_T> alloc;
+      _T* scratch = alloc.allocate(size);
+      _detail::_for_chunks(pool, blocks, [&](size_t block, size_t first, size_t last) {
+        size_t* next = offsets.data() + block * buckets;
+        for (size_t i = first; i < last; ++i) {
+          std::construct_at(scratch + next[bucket_of[i]]++, std::move(data[i]));
+        }
+      });
+
+      pool.parallel_for(0, buckets, 1, [&](size_t b) {
+        size_t first = bucket_begin[b];
+        size_t last = bucket_begin[b + 1];
+        std::sort(scratch + first, scratch + last, comp);
+        for (size_t i = first; i < last; ++i) {
+          data[i] = std::move(scratch[i]);
+          std::destroy_at(scratch + i);
+        }
+      });
+      alloc.deallocate(scratch, size);
+    }
+  }
+
+  template <contiguous_range _C, typename _Fn>
+  void for_each(_C& range, _Fn fn, size_t grain = 0) {
+    parallel::for_each(default_scheduler(), range, std::move(fn), grain);
+  }
+
+  template <contiguous_range _In, contiguous_range _Out, typename _Fn>
+  void transform(const _In& in, _Out& out, _Fn fn, size_t grain = 0) {
+    parallel::transform(default_scheduler(), in, out, std::move(fn), grain);
+  }
+
+  template <contiguous_range _C, typename _V, typename _Op = std::plus<>>
+  [[nodiscard]] _V reduce(const _C& range, _V init, _Op op = {}, size_t grain = 0) {
+    return parallel::reduce(default_scheduler(), range, std::move(init), std::move(op), grain);
+  }
+
+  template <contiguous_range _In, contiguous_range _Out, typename _Op = std::plus<>>
+  void inclusive_scan(const _In& in, _Out& out, _Op op = {}, size_t grain = 0) {
+    parallel::inclusive_scan(default_scheduler(), in, out, std::move(op), grain);
+  }
+
+  template <contiguous_range _In, contiguous_range _Out, typename _V, typename _Op = std::plus<>>
+  void exclusive_scan(const _In& in, _Out& out, _V init, _Op op = {}, size_t grain = 0) {
+    parallel::exclusive_scan(default_scheduler(), in, out, std::move(init), std::move(op), grain);
+  }
+
+  template <contiguous_range _C, typename _Cmp = std::less<>>
+  void sort(_C& range, _Cmp comp = {}, size_t grain = 0) {
+    parallel::sort(default_scheduler(), range, std::move(comp), grain);
+  }
+
+}
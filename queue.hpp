@@ -1,50 +1,61 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
 #include <format>
 #include <initializer_list>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <span>
 
 #include "array.hpp"
+#include "deque.hpp"
+#include "instrument.hpp"
 #include "vector.hpp"
 
 namespace JMK {
 
-  template <typename _T, size_t _N>
+  // Readable region of a queue's ring as up to two contiguous spans, oldest
+  // elements first
+  template <typename _T>
+  struct ring_segments {
+    std::span<_T> first;
+    std::span<_T> second;
+
+    [[nodiscard]] size_t size() const noexcept { return first.size() + second.size(); }
+    [[nodiscard]] bool empty() const noexcept { return first.empty(); }
+  };
+
+  template <typename _T, size_t _N, typename _Alloc = std::allocator<_T>>
   class queue {
   public:
     queue() = default;
 
-    queue(const JMK::queue<_T, _N>& other) noexcept(std::is_trivially_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) {
-      for (size_t i = 0; i < std::min(_N, other.size()); ++i) {
-        m_data[i] = other.m_data[i];
-      }
-      m_size = other.size();
-    }
+    queue(const queue& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) : m_data(other.m_data), m_size(other.m_size), m_index(other.m_index) {}
 
-    queue(JMK::queue<_T, _N>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) {
-      for (size_t i = 0; i < std::min(_N, other.size()); ++i) {
-        m_data[i] = std::move(other.m_data[i]);
-      }
-      m_size = other.size();
+    queue(queue&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) : m_data(std::move(other.m_data)), m_size(other.m_size), m_index(other.m_index) {
+      other.m_size = 0;
+      other.m_index = 0;
     }
 
     queue(std::initializer_list<_T> list) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) : m_data(list), m_size(list.size()) {}
 
-    queue(const JMK::array<_T, _N>& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    queue(const JMK::array<_T, _N>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) : m_data(other), m_size(other.size()) {}
 
-    queue(JMK::array<_T, _N>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    queue(JMK::array<_T, _N>&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) : m_data(std::move(other)), m_size(other.size()) {}
 
     [[nodiscard]] size_t size() const noexcept { return m_size; }
     [[nodiscard]] size_t max_size() const noexcept { return m_data.max_size(); }
 
-    [[nodiscard]] bool empty() const noexcept { return m_data.empty(); }
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
 
     [[nodiscard]] _T& front() {
       assert(m_size != 0);
@@ -68,21 +79,66 @@ namespace JMK {
 
     _T dequeue() {
       assert(m_size != 0);
-      _T res = m_data.at(m_index);
+      _T res = std::move(m_data[m_index]);
       _shift_entry();
       return res;
     }
 
+    // Copies as many elements from [first, last) as there is room for, in at
+    // most two contiguous runs, and returns how many were enqueued
+    template <std::forward_iterator _It>
+    size_t enqueue_bulk(_It first, _It last) {
+      size_t count = std::min(static_cast<size_t>(std::distance(first, last)), _N - m_size);
+      size_t tail = (m_index + m_size) % _N;
+      size_t first_count = std::min(count, _N - tail);
+      first = std::ranges::copy_n(first, first_count, &m_data[tail]).in;
+      std::ranges::copy_n(first, count - first_count, &m_data[0]);
+      m_size += count;
+      return count;
+    }
+
+    // Moves up to max elements into out and returns how many were dequeued
+    template <typename _OutIt>
+    size_t dequeue_bulk(_OutIt out, size_t max) {
+      ring_segments<_T> segments = peek_segments();
+      size_t count = std::min(max, segments.size());
+      size_t first_count = std::min(count, segments.first.size());
+      out = std::move(segments.first.begin(), segments.first.begin() + first_count, out);
+      std::move(segments.second.begin(), segments.second.begin() + (count - first_count), out);
+      consume(count);
+      return count;
+    }
+
+    // Exposes the queued elements in place. They stay queued until consume()
+    [[nodiscard]] ring_segments<_T> peek_segments() noexcept {
+      size_t first_count = std::min(m_size, _N - m_index);
+      return {
+        std::span<_T>(&m_data[m_index], first_count),
+        std::span<_T>(&m_data[0], m_size - first_count)
+      };
+    }
+
+    void consume(size_t count) noexcept {
+      assert(count <= m_size);
+      m_index = (m_index + count) % _N;
+      m_size -= count;
+    }
+
   private:
+    void _cycle_storage(const _T& data) {
+      assert(m_size < _N);
+      m_data[(m_index + m_size) % _N] = data;
+      m_size += 1;
+    }
+
     void _cycle_storage(_T&& data) {
-      size_t cyclic_capacity = m_data.capacity();
-      assert(m_size < m_data.size());
-      m_data[(m_index + m_size) % cyclic_capacity] = data;
+      assert(m_size < _N);
+      m_data[(m_index + m_size) % _N] = std::move(data);
       m_size += 1;
     }
 
     inline void _shift_entry() {
-      m_index = (m_index + 1) % m_data.size();
+      m_index = (m_index + 1) % _N;
       m_size -= 1;
     }
 
@@ -92,38 +148,76 @@ namespace JMK {
   };
 
 
-  template <typename _T>
-  class queue<_T, 0> {
+  template <typename _T, typename _Alloc>
+  class queue<_T, 0, _Alloc> {
   public:
+    using allocator_type = _Alloc;
+
     queue() = default;
 
-    queue(const JMK::queue<_T, 0>& other) noexcept(
-      std::is_trivially_constructible_v<_T>) {
-      m_data.resize(other.size());
+    explicit queue(const _Alloc& alloc) noexcept : m_data(alloc) {}
+
+    queue(const JMK::queue<_T, 0, _Alloc>& other) noexcept(
+      std::is_trivially_constructible_v<_T>) : m_data(other.get_allocator()) {
+      _reserve_storage(other.size());
       for (size_t i = 0; i < other.size(); ++i) {
-        m_data[i] = other.m_data[i];
+        m_data[i] = other.m_data[(other.m_index + i) & (other.m_data.size() - 1)];
       }
+      m_size = other.size();
+    }
+
+    queue(JMK::queue<_T, 0, _Alloc>&& other) noexcept
+      : m_data(std::move(other.m_data)), m_index(other.m_index), m_size(other.m_size),
+      m_probe(std::move(other.m_probe)) {
+      other.m_index = 0;
+      other.m_size = 0;
     }
 
-    queue(JMK::queue<_T, 0>&& other) noexcept(
+    queue(std::initializer_list<_T> list) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) {
-      m_data.resize(other.size());
-      for (size_t i = 0; i < other.size(); ++i) {
-        m_data[i] = std::move(other.at(i));
+      _reserve_storage(list.size());
+      for (const _T& item : list) {
+        m_data[m_size++] = item;
       }
     }
 
-    queue(std::initializer_list<_T> list) noexcept(std::is_trivially_copy_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) : m_data(list) {}
+    queue(const JMK::vector<_T, _Alloc>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) : m_data(other.get_allocator()) {
+      _reserve_storage(other.size());
+      for (const _T& item : other) {
+        m_data[m_size++] = item;
+      }
+    }
 
-    queue(const JMK::array<_T, 0>& other) noexcept(std::is_trivially_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) : m_data(other) {}
+    queue(JMK::vector<_T, _Alloc>&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) : m_data(std::move(other)), m_size(m_data.size()) {
+      // Adopt the buffer as is and pad it out to the next power of two
+      m_data.resize_default_init(std::bit_ceil(std::max(m_size, _min_capacity)));
+    }
 
-    queue(JMK::array<_T, 0>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) : m_data(std::move(other)) {}
+    queue& operator=(const queue& other) {
+      if (this != &other) {
+        queue copy(other);
+        *this = std::move(copy);
+      }
+      return *this;
+    }
+
+    queue& operator=(queue&& other) noexcept {
+      if (this != &other) {
+        m_data = std::move(other.m_data);
+        m_index = other.m_index;
+        m_size = other.m_size;
+        m_probe = std::move(other.m_probe);
+        other.m_index = 0;
+        other.m_size = 0;
+      }
+      return *this;
+    }
 
     [[nodiscard]] size_t size() const noexcept { return m_size; }
     [[nodiscard]] size_t max_size() const noexcept { return m_data.max_size(); }
+    [[nodiscard]] size_t capacity() const noexcept { return m_data.size(); }
 
     [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
 
@@ -143,82 +237,256 @@ namespace JMK {
     }
 
     void enqueue(_T&& item) noexcept(std::is_trivially_copy_assignable_v<_T>&& std::is_trivially_constructible_v<_T>) {
-      m_data.push_back(item);
+      assert(m_size < max_size());
       _cycle_storage(std::move(item));
     }
 
     _T dequeue() {
       assert(m_size != 0);
-      _T res = m_data.at(m_index);
+      _T res = std::move(m_data[m_index]);
       _shift_entry();
       return res;
     }
 
+    // Grows at most once to fit [first, last), then copies it in at most two
+    // contiguous runs
+    template <std::forward_iterator _It>
+    size_t enqueue_bulk(_It first, _It last) {
+      size_t count = static_cast<size_t>(std::distance(first, last));
+      if (m_size + count > m_data.size()) {
+        _realloc_storage(m_size + count);
+      }
+      size_t tail = (m_index + m_size) & _mask();
+      size_t first_count = std::min(count, m_data.size() - tail);
+      first = std::ranges::copy_n(first, first_count, &m_data[tail]).in;
+      std::ranges::copy_n(first, count - first_count, m_data.data());
+      m_size += count;
+      return count;
+    }
+
+    // Moves up to max elements into out and returns how many were dequeued
+    template <typename _OutIt>
+    size_t dequeue_bulk(_OutIt out, size_t max) {
+      ring_segments<_T> segments = peek_segments();
+      size_t count = std::min(max, segments.size());
+      size_t first_count = std::min(count, segments.first.size());
+      out = std::move(segments.first.begin(), segments.first.begin() + first_count, out);
+      std::move(segments.second.begin(), segments.second.begin() + (count - first_count), out);
+      consume(count);
+      return count;
+    }
+
+    // Exposes the queued elements in place. They stay queued until consume()
+    [[nodiscard]] ring_segments<_T> peek_segments() noexcept {
+      if (m_size == 0) {
+        return {};
+      }
+      size_t first_count = std::min(m_size, m_data.size() - m_index);
+      return {
+        std::span<_T>(&m_data[m_index], first_count),
+        std::span<_T>(m_data.data(), m_size - first_count)
+      };
+    }
+
+    void consume(size_t count) noexcept {
+      assert(count <= m_size);
+      if (count != 0) {
+        m_index = (m_index + count) & _mask();
+        m_size -= count;
+      }
+    }
+
     void clear() noexcept(std::is_trivially_copy_assignable_v<_T>&& std::is_trivially_constructible_v<_T>) {
       m_data.clear();
+      m_index = 0;
       m_size = 0;
     }
 
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_data.get_allocator(); }
+
+    // Growth of the ring and every element it relocated, with the allocation
+    // counts of the vector underneath. The queue's type aggregate only sees
+    // the growth; the allocations are aggregated under that vector's type.
+    [[nodiscard]] JMK::instrument::counters instrumentation() const noexcept {
+      JMK::instrument::counters out = m_probe.get();
+      JMK::instrument::counters storage = m_data.instrumentation();
+      out.allocations = storage.allocations;
+      out.deallocations = storage.deallocations;
+      out.bytes_allocated = storage.bytes_allocated;
+      out.bytes_freed = storage.bytes_freed;
+      return out;
+    }
+
     // Friend declaration for the stream operator
-    template <typename _Ty, size_t _S>
-    friend std::ostream& operator<<(std::ostream& os, const JMK::queue<_Ty, _S>& obj);
+    template <typename _Ty, size_t _S, typename _TyAlloc>
+    friend std::ostream& operator<<(std::ostream& os, const JMK::queue<_Ty, _S, _TyAlloc>& obj);
 
   private:
+    static constexpr size_t _min_capacity = 8;
+
+    // Storage always holds a power of two slots so positions wrap with a mask
+    [[nodiscard]] size_t _mask() const noexcept { return m_data.size() - 1; }
+
     void _cycle_storage(const _T& data) {
-      size_t cyclic_capacity = m_data.size();
-      if (m_size >= cyclic_capacity) {
+      if (m_size >= m_data.size()) {
         _realloc_storage();
-        cyclic_capacity = m_data.size();
       }
-      m_data[(m_index + m_size) % cyclic_capacity] = data;
+      m_data[(m_index + m_size) & _mask()] = data;
       m_size += 1;
     }
 
     void _cycle_storage(_T&& data) {
-      size_t cyclic_capacity = m_data.size();
-      if (m_size >= cyclic_capacity) {
+      if (m_size >= m_data.size()) {
         _realloc_storage();
-        cyclic_capacity = m_data.size();
       }
-      m_data[(m_index + m_size) % cyclic_capacity] = data;
+      m_data[(m_index + m_size) & _mask()] = std::move(data);
       m_size += 1;
     }
 
-    void _realloc_storage() {
-      if (m_index > 0) {
-        JMK::vector<_T> new_storage;
-        new_storage.resize(static_cast<size_t>(m_data.capacity() * 1.5));
+    void _reserve_storage(size_t count) {
+      size_t capacity = std::bit_ceil(std::max(count, _min_capacity));
+      m_probe.on_grow(m_data.size(), capacity, 0);
+      m_data.reserve(capacity);
+      m_data.resize_default_init(capacity);
+    }
 
-        // Copy the shifted beginning to true beginning
-        std::memcpy(&new_storage[0], &m_data[m_index], m_data.size() - m_index);
+    // At least doubles the ring. The vector relocates the block as a whole, then only
+    // the smaller of the two wrapped segments is moved to make the live range
+    // contiguous modulo the new capacity again.
+    void _realloc_storage(size_t min_capacity = 0) {
+      size_t old_capacity = m_data.size();
+      if (old_capacity == 0) {
+        _reserve_storage(min_capacity);
+        m_index = 0;
+        return;
+      }
 
-        // Copy the shifted end to true end
-        std::memcpy(&new_storage[m_data.size() - m_index], &m_data[0], m_index);
+      size_t new_capacity = std::bit_ceil(std::max(old_capacity * 2, min_capacity));
+      m_data.reserve(new_capacity);
+      m_data.resize_default_init(new_capacity);
 
-        m_data = std::move(new_storage);
+      if (m_index + m_size <= old_capacity) {
+        m_probe.on_grow(old_capacity, new_capacity, old_capacity * sizeof(_T));
         return;
       }
+      size_t tail_count = old_capacity - m_index;
+      size_t head_count = m_size - tail_count;
+      // The vector relocated the whole old ring, then one segment moves again
+      m_probe.on_grow(old_capacity, new_capacity, (old_capacity + std::min(head_count, tail_count)) * sizeof(_T));
 
-      m_data.resize(static_cast<size_t>(m_data.capacity() * 1.5));
+      if (head_count <= tail_count) {
+        _move_elements(&m_data[old_capacity], &m_data[0], head_count);
+      }
+      else {
+        size_t new_index = new_capacity - tail_count;
+        _move_elements(&m_data[new_index], &m_data[m_index], tail_count);
+        m_index = new_index;
+      }
+    }
+
+    // Both ranges hold live objects and never overlap
+    static void _move_elements(_T* dst, _T* src, size_t count) {
+      if constexpr (std::is_trivially_copyable_v<_T>) {
+        std::memcpy(dst, src, count * sizeof(_T));
+      }
+      else {
+        std::move(src, src + count, dst);
+      }
     }
 
     inline void _shift_entry() {
-      m_index = (m_index + 1) % m_data.size();
+      m_index = (m_index + 1) & _mask();
       m_size -= 1;
     }
 
-    JMK::vector<_T> m_data;
+    JMK::vector<_T, _Alloc> m_data;
     size_t m_index = 0;
     size_t m_size = 0;
+    [[no_unique_address]] JMK::instrument::probe<queue> m_probe;
+  };
+
+
+  // Backed by JMK::deque. Growing allocates one more block instead of
+  // relocating the whole backlog, so enqueue never stalls on a large copy.
+  template <typename _T, typename _Alloc>
+  class queue<_T, segmented_extent, _Alloc> {
+  public:
+    using allocator_type = _Alloc;
+
+    queue() = default;
+
+    explicit queue(const _Alloc& alloc) noexcept : m_data(alloc) {}
+
+    queue(std::initializer_list<_T> list) : m_data(list) {}
+
+    [[nodiscard]] size_t size() const noexcept { return m_data.size(); }
+    [[nodiscard]] size_t max_size() const noexcept { return m_data.max_size(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_data.empty(); }
+
+    [[nodiscard]] _T& front() noexcept {
+      assert(size() != 0);
+      return m_data.front();
+    }
+
+    [[nodiscard]] const _T& front() const noexcept {
+      assert(size() != 0);
+      return m_data.front();
+    }
+
+    void enqueue(const _T& item) {
+      m_data.push_back(item);
+    }
+
+    void enqueue(_T&& item) {
+      m_data.push_back(std::move(item));
+    }
+
+    _T dequeue() {
+      assert(size() != 0);
+      return m_data.pop_front();
+    }
+
+    template <std::forward_iterator _It>
+    size_t enqueue_bulk(_It first, _It last) {
+      size_t count = 0;
+      for (; first != last; ++first, ++count) {
+        m_data.push_back(*first);
+      }
+      return count;
+    }
+
+    template <typename _OutIt>
+    size_t dequeue_bulk(_OutIt out, size_t max) {
+      size_t count = std::min(max, m_data.size());
+      for (size_t i = 0; i < count; ++i) {
+        *out = m_data.pop_front();
+        ++out;
+      }
+      return count;
+    }
+
+    void clear() noexcept {
+      m_data.clear();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_data.get_allocator(); }
+
+    // Friend declaration for the stream operator
+    template <typename _Ty, size_t _S, typename _TyAlloc>
+    friend std::ostream& operator<<(std::ostream& os, const JMK::queue<_Ty, _S, _TyAlloc>& obj);
+
+  private:
+    JMK::deque<_T, _Alloc> m_data;
   };
 
 }
 
 namespace JMK {
 
-  template <typename _T, size_t _N>
-  inline std::ostream& operator<<(std::ostream& os, const JMK::queue<_T, _N>& obj) {
-    JMK::queue<_T, _N> copy(obj);
+  template <typename _T, size_t _N, typename _Alloc>
+  inline std::ostream& operator<<(std::ostream& os, const JMK::queue<_T, _N, _Alloc>& obj) {
+    JMK::queue<_T, _N, _Alloc> copy(obj);
 
     os << "+" << std::string(13, ' ') << "+" << std::endl;
     while (!copy.empty()) {
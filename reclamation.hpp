@@ -0,0 +1,320 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "traits.hpp"
+#include "vector.hpp"
+
+namespace JMK {
+
+  enum class reclamation_mode {
+    epoch,
+    hazard_pointers
+  };
+
+  // Deferred freeing for lock-free node containers. Readers enter a guard
+  // before touching shared nodes; writers retire() unlinked nodes instead of
+  // deleting them, and the domain frees them once no guard can still see them.
+  //
+  // In epoch mode a guard pins the current global epoch, and retired nodes are
+  // freed two epochs later. In hazard pointer mode a guard publishes the exact
+  // pointers it protect()s, which bounds unreclaimed memory even when a reader
+  // stalls, at the cost of a fence per protected load.
+  //
+  // Every thread gets its own record holding its retire list, so retiring
+  // never contends; a list is scanned in batches once it reaches the retire
+  // threshold. Records are recycled when their thread exits.
+  class reclamation_domain {
+  public:
+    static constexpr size_t max_hazards = 8;
+    static constexpr size_t default_retire_threshold = 64;
+
+  private:
+    struct _retired {
+      void* m_ptr;
+      void (*m_deleter)(void*);
+      uint64_t m_epoch;
+    };
+
+    enum _record_state : uint32_t {
+      _free,
+      _owned,
+      _orphaned
+    };
+
+    struct alignas(JMK::cache_line_size) _record {
+      // Pinned epoch shifted left by one, low bit set while inside a guard
+      std::atomic<uint64_t> m_local = 0;
+      std::atomic<void*> m_hazards[max_hazards] = {};
+      std::atomic<uint32_t> m_state = _owned;
+      _record* m_next = nullptr;
+
+      // Owner only
+      JMK::vector<_retired> m_retired;
+      size_t m_next_scan = 0;
+      uint32_t m_nesting = 0;
+    };
+
+  public:
+    class guard {
+    public:
+      explicit guard(reclamation_domain& domain) : m_domain(&domain), m_record(domain._local_record()) {
+        m_domain->_enter(*m_record);
+      }
+
+      guard(const guard&) = delete;
+      guard& operator=(const guard&) = delete;
+
+      ~guard() { m_domain->_leave(*m_record); }
+
+      // Loads src and keeps the result alive for the rest of the guard. In
+      // hazard pointer mode each slot protects one pointer at a time, and
+      // nested guards on a thread share its slots, so an inner guard must
+      // use slots the outer ones are not holding.
+      template <typename _T>
+      [[nodiscard]] _T* protect(const std::atomic<_T*>& src, size_t slot = 0) noexcept {
+        if (m_domain->m_mode == reclamation_mode::epoch) {
+          return src.load(std::memory_order_acquire);
+        }
+        assert(slot < max_hazards);
+        _T* ptr = src.load(std::memory_order_relaxed);
+        for (;;) {
+          m_record->m_hazards[slot].store(ptr, std::memory_order_seq_cst);
+          _T* current = src.load(std::memory_order_acquire);
+          if (current == ptr) {
+            return ptr;
+          }
+          ptr = current;
+        }
+      }
+
+      void reset(size_t slot) noexcept {
+        m_record->m_hazards[slot].store(nullptr, std::memory_order_release);
+      }
+
+    private:
+      reclamation_domain* m_domain;
+      _record* m_record;
+    };
+
+    explicit reclamation_domain(reclamation_mode mode = reclamation_mode::epoch,
+      size_t retire_threshold = default_retire_threshold) noexcept
+      : m_mode(mode), m_retire_threshold(std::max<size_t>(retire_threshold, 1)),
+      m_id(s_next_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+    reclamation_domain(const reclamation_domain&) = delete;
+    reclamation_domain& operator=(const reclamation_domain&) = delete;
+
+    // No guard may be active. Frees everything still retired; records whose
+    // thread is alive are handed over to that thread to delete on exit.
+    ~reclamation_domain() {
+      _record* record = m_records.load(std::memory_order_acquire);
+      while (record) {
+        _record* next = record->m_next;
+        for (const _retired& item : record->m_retired) {
+          item.m_deleter(item.m_ptr);
+        }
+        record->m_retired.clear();
+
+        uint32_t state = _free;
+        if (record->m_state.compare_exchange_strong(state, _orphaned, std::memory_order_acq_rel)) {
+          delete record;
+        }
+        else {
+          state = _owned;
+          if (!record->m_state.compare_exchange_strong(state, _orphaned, std::memory_order_acq_rel)) {
+            // Its thread released it in the meantime
+            delete record;
+          }
+        }
+        record = next;
+      }
+    }
+
+    [[nodiscard]] reclamation_mode mode() const noexcept { return m_mode; }
+    [[nodiscard]] size_t retire_threshold() const noexcept { return m_retire_threshold; }
+
+    void set_retire_threshold(size_t threshold) noexcept {
+      m_retire_threshold = std::max<size_t>(threshold, 1);
+    }
+
+    template <typename _T>
+    void retire(_T* ptr) {
+      retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<_T*>(p); });
+    }
+
+    // Frees ptr through deleter once no guard can reach it
+    void retire(void* ptr, void (*deleter)(void*)) {
+      _record& record = *_local_record();
+      // Stamp with an epoch no older than that of any guard that saw ptr linked
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      record.m_retired.emplace_back(_retired { ptr, deleter, m_epoch.load(std::memory_order_relaxed) });
+      if (record.m_retired.size() >= record.m_next_scan) {
+        _scan(record);
+      }
+    }
+
+    // Frees whatever the calling thread retired that is already safe.
+    // Returns the number of objects freed.
+    size_t collect() {
+      return _scan(*_local_record());
+    }
+
+    // Objects retired by the calling thread and not yet freed
+    [[nodiscard]] size_t pending() {
+      return _local_record()->m_retired.size();
+    }
+
+  private:
+    // Per-thread map from domain id to record; releases the records when the
+    // thread exits, or deletes them if their domain is already gone
+    struct _thread_cache {
+      struct _entry {
+        uint64_t m_domain;
+        _record* m_record;
+      };
+
+      ~_thread_cache() {
+        for (const _entry& entry : m_entries) {
+          uint32_t state = _owned;
+          if (!entry.m_record->m_state.compare_exchange_strong(state, _free, std::memory_order_acq_rel)) {
+            delete entry.m_record;
+          }
+        }
+      }
+
+      JMK::vector<_entry> m_entries;
+    };
+
+    _record* _local_record() {
+      _thread_cache& cache = s_cache;
+      for (const auto& entry : cache.m_entries) {
+        if (entry.m_domain == m_id) {
+          return entry.m_record;
+        }
+      }
+      _record* record = _acquire_record();
+      cache.m_entries.emplace_back(_thread_cache::_entry { m_id, record });
+      return record;
+    }
+
+    _record* _acquire_record() {
+      for (_record* record = m_records.load(std::memory_order_acquire); record; record = record->m_next) {
+        uint32_t state = _free;
+        if (record->m_state.compare_exchange_strong(state, _owned, std::memory_order_acq_rel)) {
+          return record;
+        }
+      }
+      _record* record = new _record;
+      record->m_next_scan = m_retire_threshold;
+      _record* head = m_records.load(std::memory_order_relaxed);
+      do {
+        record->m_next = head;
+      } while (!m_records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+      return record;
+    }
+
+    // Guards nest on one thread; only the outermost one pins an epoch, and
+    // hazards stay published until it leaves
+    void _enter(_record& record) noexcept {
+      if (record.m_nesting++ != 0 || m_mode != reclamation_mode::epoch) {
+        return;
+      }
+      // The fence orders the announcement before any load of shared nodes, and
+      // pairs with the one in _try_advance
+      record.m_local.store((m_epoch.load(std::memory_order_seq_cst) << 1) | 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void _leave(_record& record) noexcept {
+      if (--record.m_nesting != 0) {
+        return;
+      }
+      if (m_mode == reclamation_mode::epoch) {
+        record.m_local.store(0, std::memory_order_release);
+        return;
+      }
+      for (std::atomic<void*>& hazard : record.m_hazards) {
+        hazard.store(nullptr, std::memory_order_release);
+      }
+    }
+
+    // Moves the global epoch forward if every pinned thread has seen it
+    uint64_t _try_advance() noexcept {
+      uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      for (_record* record = m_records.load(std::memory_order_acquire); record; record = record->m_next) {
+        uint64_t local = record->m_local.load(std::memory_order_acquire);
+        if ((local & 1) && (local >> 1) != epoch) {
+          return epoch;
+        }
+      }
+      if (m_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return epoch + 1;
+      }
+      return epoch;
+    }
+
+    size_t _scan(_record& record) {
+      JMK::vector<_retired>& retired = record.m_retired;
+      size_t kept = 0;
+
+      if (m_mode == reclamation_mode::epoch) {
+        uint64_t epoch = _try_advance();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        for (size_t i = 0; i < retired.size(); ++i) {
+          if (retired[i].m_epoch + 2 <= epoch) {
+            retired[i].m_deleter(retired[i].m_ptr);
+          }
+          else {
+            retired[kept++] = retired[i];
+          }
+        }
+      }
+      else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        JMK::vector<void*> hazards;
+        for (_record* other = m_records.load(std::memory_order_acquire); other; other = other->m_next) {
+          for (const std::atomic<void*>& hazard : other->m_hazards) {
+            void* ptr = hazard.load(std::memory_order_acquire);
+            if (ptr) {
+              hazards.push_back(ptr);
+            }
+          }
+        }
+        void** first = hazards.data();
+        void** last = first + hazards.size();
+        std::sort(first, last);
+        for (size_t i = 0; i < retired.size(); ++i) {
+          if (!std::binary_search(first, last, retired[i].m_ptr)) {
+            retired[i].m_deleter(retired[i].m_ptr);
+          }
+          else {
+            retired[kept++] = retired[i];
+          }
+        }
+      }
+
+      size_t freed = retired.size() - kept;
+      retired.resize(kept);
+      // Survivors stay for the next batch instead of being rescanned on every retire
+      record.m_next_scan = kept + m_retire_threshold;
+      return freed;
+    }
+
+    static inline std::atomic<uint64_t> s_next_id = 1;
+    static inline thread_local _thread_cache s_cache;
+
+    reclamation_mode m_mode;
+    size_t m_retire_threshold;
+    uint64_t m_id;
+
+    alignas(JMK::cache_line_size) std::atomic<uint64_t> m_epoch = 0;
+    std::atomic<_record*> m_records = nullptr;
+  };
+
+}
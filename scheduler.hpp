@@ -0,0 +1,282 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "backoff.hpp"
+#include "queue.hpp"
+#include "vector.hpp"
+#include "work_stealing_deque.hpp"
+
+namespace JMK {
+
+  class task {
+  public:
+    virtual ~task() = default;
+    virtual void execute() = 0;
+  };
+
+  // Fork/join thread pool. Every worker owns a work_stealing_deque; tasks
+  // spawned on a worker go to the bottom of its own deque, tasks submitted
+  // from outside go through a shared injection queue, and idle workers steal
+  // from randomly chosen victims before parking.
+  class scheduler {
+    struct _worker {
+      explicit _worker(scheduler* owner, size_t index) noexcept
+        : m_owner(owner), m_index(index), m_seed(static_cast<uint32_t>(index) * 2654435761u + 1) {}
+
+      JMK::work_stealing_deque<JMK::task*> m_deque;
+      scheduler* m_owner;
+      size_t m_index;
+      uint32_t m_seed;
+    };
+
+    template <typename _Fn>
+    class _fn_task : public JMK::task {
+    public:
+      explicit _fn_task(_Fn&& fn) : m_fn(std::move(fn)) {}
+      void execute() override { m_fn(); }
+
+    private:
+      _Fn m_fn;
+    };
+
+  public:
+    explicit scheduler(size_t thread_count = std::max(1u, std::thread::hardware_concurrency())) {
+      thread_count = std::max<size_t>(thread_count, 1);
+      m_workers.reserve(thread_count);
+      for (size_t i = 0; i < thread_count; ++i) {
+        m_workers.emplace_back(std::make_unique<_worker>(this, i));
+      }
+      m_threads.reserve(thread_count);
+      for (size_t i = 0; i < thread_count; ++i) {
+        m_threads.emplace_back([this, i] { _worker_loop(*m_workers[i]); });
+      }
+    }
+
+    scheduler(const scheduler&) = delete;
+    scheduler& operator=(const scheduler&) = delete;
+
+    ~scheduler() {
+      m_stop.store(true, std::memory_order_seq_cst);
+      m_epoch.fetch_add(1, std::memory_order_seq_cst);
+      m_epoch.notify_all();
+      for (std::thread& thread : m_threads) {
+        thread.join();
+      }
+      JMK::task* leftover;
+      while (_pop_injected(leftover)) {
+        delete leftover;
+      }
+      for (const auto& worker : m_workers) {
+        while (worker->m_deque.try_pop(leftover)) {
+          delete leftover;
+        }
+      }
+    }
+
+    [[nodiscard]] size_t thread_count() const noexcept { return m_workers.size(); }
+
+    // Schedules fn to run on some worker. The scheduler owns the task.
+    template <typename _Fn>
+    void submit(_Fn&& fn) {
+      _spawn(new _fn_task<std::decay_t<_Fn>>(std::decay_t<_Fn>(std::forward<_Fn>(fn))));
+    }
+
+    // Calls fn(i) for every i in [first, last). The range is split in halves
+    // down to grain sized chunks, and the calling thread helps execute them
+    // until every chunk has finished.
+    template <typename _Fn>
+    void parallel_for(size_t first, size_t last, size_t grain, _Fn&& fn) {
+      if (first >= last) {
+        return;
+      }
+      grain = std::max<size_t>(grain, 1);
+      if (last - first <= grain) {
+        for (size_t i = first; i < last; ++i) {
+          fn(i);
+        }
+        return;
+      }
+
+      std::atomic<size_t> pending = 1;
+      _spawn(new _range_task<std::remove_reference_t<_Fn>>(this, fn, pending, first, last, grain));
+      wait_for(pending);
+    }
+
+    template <typename _Fn>
+    void parallel_for(size_t first, size_t last, _Fn&& fn) {
+      size_t chunks = thread_count() * 8;
+      parallel_for(first, last, std::max<size_t>((last - first) / chunks, 1), std::forward<_Fn>(fn));
+    }
+
+    // Runs queued tasks on the calling thread until counter drops to zero
+    void wait_for(const std::atomic<size_t>& counter) {
+      JMK::backoff idle;
+      while (counter.load(std::memory_order_acquire) != 0) {
+        JMK::task* next;
+        if (_find_task(s_current && s_current->m_owner == this ? s_current : nullptr, next)) {
+          _run(next);
+          idle.reset();
+        }
+        else {
+          idle.snooze();
+        }
+      }
+    }
+
+  private:
+    template <typename _Fn>
+    class _range_task : public JMK::task {
+    public:
+      _range_task(scheduler* owner, _Fn& fn, std::atomic<size_t>& pending, size_t first, size_t last, size_t grain) noexcept
+        : m_owner(owner), m_fn(fn), m_pending(pending), m_first(first), m_last(last), m_grain(grain) {}
+
+      void execute() override {
+        // Hand the upper halves to thieves and keep the lowest chunk
+        while (m_last - m_first > m_grain) {
+          size_t mid = m_first + (m_last - m_first) / 2;
+          m_pending.fetch_add(1, std::memory_order_relaxed);
+          m_owner->_spawn(new _range_task(m_owner, m_fn, m_pending, mid, m_last, m_grain));
+          m_last = mid;
+        }
+        for (size_t i = m_first; i < m_last; ++i) {
+          m_fn(i);
+        }
+        m_pending.fetch_sub(1, std::memory_order_release);
+      }
+
+    private:
+      scheduler* m_owner;
+      _Fn& m_fn;
+      std::atomic<size_t>& m_pending;
+      size_t m_first;
+      size_t m_last;
+      size_t m_grain;
+    };
+
+    void _spawn(JMK::task* t) {
+      if (s_current && s_current->m_owner == this) {
+        s_current->m_deque.push(t);
+      }
+      else {
+        std::scoped_lock lock(m_inject_mutex);
+        m_injected.enqueue(t);
+        m_inject_count.fetch_add(1, std::memory_order_relaxed);
+      }
+      _wake_one();
+    }
+
+    // Pairs with the increment of m_sleepers in _worker_loop: either the
+    // sleeper sees the new task or this sees the sleeper
+    void _wake_one() {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (m_sleepers.load(std::memory_order_relaxed) != 0) {
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_one();
+      }
+    }
+
+    bool _pop_injected(JMK::task*& out) {
+      if (m_inject_count.load(std::memory_order_relaxed) == 0) {
+        return false;
+      }
+      std::scoped_lock lock(m_inject_mutex);
+      if (m_injected.empty()) {
+        return false;
+      }
+      out = m_injected.dequeue();
+      m_inject_count.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    bool _find_task(_worker* self, JMK::task*& out) {
+      if (self && self->m_deque.try_pop(out)) {
+        return true;
+      }
+      if (_pop_injected(out)) {
+        return true;
+      }
+      size_t count = m_workers.size();
+      uint32_t seed = self ? self->m_seed : static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&out) >> 4);
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      if (self) {
+        self->m_seed = seed;
+      }
+      size_t start = seed % count;
+      for (size_t i = 0; i < count; ++i) {
+        _worker& victim = *m_workers[(start + i) % count];
+        if (&victim != self && victim.m_deque.try_steal(out)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool _has_work() const noexcept {
+      if (m_inject_count.load(std::memory_order_relaxed) != 0) {
+        return true;
+      }
+      for (const auto& worker : m_workers) {
+        if (!worker->m_deque.empty()) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    static void _run(JMK::task* t) {
+      t->execute();
+      delete t;
+    }
+
+    void _worker_loop(_worker& self) {
+      s_current = &self;
+      JMK::backoff idle;
+      while (!m_stop.load(std::memory_order_acquire)) {
+        JMK::task* next;
+        if (_find_task(&self, next)) {
+          _run(next);
+          idle.reset();
+          continue;
+        }
+        if (!idle.is_completed()) {
+          idle.snooze();
+          continue;
+        }
+
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint32_t epoch = m_epoch.load(std::memory_order_seq_cst);
+        if (!_has_work() && !m_stop.load(std::memory_order_seq_cst)) {
+          m_epoch.wait(epoch, std::memory_order_acquire);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        idle.reset();
+      }
+      s_current = nullptr;
+    }
+
+    static inline thread_local _worker* s_current = nullptr;
+
+    JMK::vector<std::unique_ptr<_worker>> m_workers;
+    JMK::vector<std::thread> m_threads;
+
+    std::mutex m_inject_mutex;
+    JMK::queue<JMK::task*, 0> m_injected;
+    std::atomic<size_t> m_inject_count = 0;
+
+    alignas(JMK::cache_line_size) std::atomic<uint32_t> m_epoch = 0;
+    std::atomic<uint32_t> m_sleepers = 0;
+    std::atomic<bool> m_stop = false;
+  };
+
+}
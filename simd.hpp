@@ -0,0 +1,529 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+// Vectorized algorithms over contiguous runs of arithmetic values. Kernels are
+// written once with GCC vector extensions and instantiated per instruction
+// set; on x86 the widest one the CPU supports is picked at runtime. Other
+// compilers get the scalar loops.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JMK_SIMD_X86 1
+#define JMK_SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace JMK::simd {
+
+  // Instruction sets the kernels are built for, narrowest first
+  enum class isa : uint8_t {
+    scalar,
+    sse2,
+    avx2,
+    avx512
+  };
+
+  // Element types the kernels accept
+  template <typename _T>
+  concept arithmetic = std::is_arithmetic_v<_T> && !std::is_same_v<_T, bool>;
+
+  // Anything exposing data() and size() over arithmetic values: std::span,
+  // JMK::array, JMK::vector, JMK::small_vector, ...
+  template <typename _C>
+  concept contiguous = requires(_C& c) {
+    { c.data() } -> std::convertible_to<const void*>;
+    { c.size() } -> std::convertible_to<size_t>;
+  } && arithmetic<std::remove_cvref_t<decltype(*std::declval<_C&>().data())>>;
+
+  template <contiguous _C>
+  using element_t = std::remove_cvref_t<decltype(*std::declval<_C&>().data())>;
+
+  // sum() and dot() add integers in 64 bits and floating point values in
+  // their own type
+  template <arithmetic _T>
+  using accumulator_t = std::conditional_t<std::is_floating_point_v<_T>, _T,
+    std::conditional_t<std::is_signed_v<_T>, int64_t, uint64_t>>;
+
+  namespace _detail {
+
+    [[nodiscard]] inline isa _detect() noexcept {
+#if defined(JMK_SIMD_X86)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return isa::avx512;
+      }
+      if (__builtin_cpu_supports("avx2")) {
+        return isa::avx2;
+      }
+      if (__builtin_cpu_supports("sse2")) {
+        return isa::sse2;
+      }
+#endif
+      return isa::scalar;
+    }
+
+    inline const isa _detected = _detect();
+
+    // Reads as scalar until static initialization has run, which is always safe
+    inline std::atomic<isa> _active = _detected;
+
+#if defined(__GNUC__)
+    template <typename _T, size_t _Bytes>
+    struct _vector {
+      typedef _T type __attribute__((vector_size(_Bytes)));
+      typedef _T unaligned __attribute__((vector_size(_Bytes), aligned(alignof(_T)), may_alias));
+      typedef unaligned* pointer;
+      typedef const unaligned* const_pointer;
+    };
+
+    template <typename _T, size_t _Bytes>
+    using _vec = typename _vector<_T, _Bytes>::type;
+
+    template <size_t _Size>
+    using _unsigned_lane = std::conditional_t<_Size == 1, uint8_t,
+      std::conditional_t<_Size == 2, uint16_t,
+      std::conditional_t<_Size == 4, uint32_t, uint64_t>>>;
+
+    // The vector starting at ptr, which only needs element alignment
+    template <size_t _Bytes, typename _T>
+    [[gnu::always_inline]] inline auto& _at(_T* ptr) noexcept {
+      return *reinterpret_cast<typename _vector<_T, _Bytes>::pointer>(ptr);
+    }
+
+    template <size_t _Bytes, typename _T>
+    [[gnu::always_inline]] inline const auto& _at(const _T* ptr) noexcept {
+      return *reinterpret_cast<typename _vector<_T, _Bytes>::const_pointer>(ptr);
+    }
+
+    template <typename _M>
+    [[gnu::always_inline]] inline bool _any(const _M& mask) noexcept {
+      using _W = _vec<uint64_t, sizeof(_M)>;
+      _W words = (_W)mask;
+      uint64_t bits = 0;
+      for (size_t k = 0; k < sizeof(_M) / sizeof(uint64_t); ++k) {
+        bits |= words[k];
+      }
+      return bits != 0;
+    }
+#endif
+
+    // Whether _T has a vector kernel at _Bytes wide; zero means scalar
+    template <typename _T, size_t _Bytes>
+    inline constexpr bool _vectorized = _Bytes != 0 && sizeof(_T) <= 8 && _Bytes / sizeof(_T) >= 2;
+
+    template <size_t _Bytes>
+    struct _fill {
+      template <typename _T>
+      [[gnu::always_inline]] static void run(_T* data, size_t count, _T value) noexcept {
+        size_t i = 0;
+#if defined(__GNUC__)
+        if constexpr (_vectorized<_T, _Bytes>) {
+          using _V = _vec<_T, _Bytes>;
+          constexpr size_t lanes = _Bytes / sizeof(_T);
+          _V v = _V{} + value;
+          for (; i + lanes <= count; i += lanes) {
+            _at<_Bytes>(data + i) = v;
+          }
+        }
+#endif
+        for (; i < count; ++i) {
+          data[i] = value;
+        }
+      }
+    };
+
+    template <size_t _Bytes>
+    struct _find {
+      template <typename _T>
+      [[gnu::always_inline]] static size_t run(const _T* data, size_t count, _T value) noexcept {
+        size_t i = 0;
+#if defined(__GNUC__)
+        if constexpr (_vectorized<_T, _Bytes>) {
+          using _V = _vec<_T, _Bytes>;
+          constexpr size_t lanes = _Bytes / sizeof(_T);
+          _V v = _V{} + value;
+          for (; i + lanes <= count; i += lanes) {
+            auto hit = _at<_Bytes>(data + i) == v;
+            if (_any(hit)) {
+              for (size_t k = 0; k < lanes; ++k) {
+                if (hit[k]) {
+                  return i + k;
+                }
+              }
+            }
+          }
+        }
+#endif
+        for (; i < count; ++i) {
+          if (data[i] == value) {
+            return i;
+          }
+        }
+        return count;
+      }
+    };
+
+    template <size_t _Bytes>
+    struct _mismatch {
+      template <typename _T>
+      [[gnu::always_inline]] static size_t run(const _T* lhs, const _T* rhs, size_t count) noexcept {
+        size_t i = 0;
+#if defined(__GNUC__)
+        if constexpr (_vectorized<_T, _Bytes>) {
+          constexpr size_t lanes = _Bytes / sizeof(_T);
+          for (; i + lanes <= count; i += lanes) {
+            auto differ = _at<_Bytes>(lhs + i) != _at<_Bytes>(rhs + i);
+            if (_any(differ)) {
+              for (size_t k = 0; k < lanes; ++k) {
+                if (differ[k]) {
+                  return i + k;
+                }
+              }
+            }
+          }
+        }
+#endif
+        for (; i < count; ++i) {
+          if (lhs[i] != rhs[i]) {
+            return i;
+          }
+        }
+        return count;
+      }
+    };
+
+    template <size_t _Bytes>
+    struct _count {
+      template <typename _T>
+      [[gnu::always_inline]] static size_t run(const _T* data, size_t count, _T value) noexcept {
+        size_t total = 0;
+        size_t i = 0;
+#if defined(__GNUC__)
+        if constexpr (_vectorized<_T, _Bytes>) {
+          using _V = _vec<_T, _Bytes>;
+          using _U = _unsigned_lane<sizeof(_T)>;
+          using _C = _vec<_U, _Bytes>;
+          constexpr size_t lanes = _Bytes / sizeof(_T);
+          // Lane counters are flushed before they can wrap
+          constexpr size_t flush = std::min<size_t>(std::numeric_limits<_U>::max(), size_t(1) << 20);
+          _V v = _V{} + value;
+          while (i + lanes <= count) {
+            _C counters = {};
+            size_t blocks = std::min((count - i) / lanes, flush);
+            for (size_t b = 0; b < blocks; ++b, i += lanes) {
+              // Matching lanes compare as all ones, so subtracting counts them
+              counters -= __builtin_convertvector(_at<_Bytes>(data + i) == v, _C);
+            }
+            for (size_t k = 0; k < lanes; ++k) {
+              total += counters[k];
+            }
+          }
+        }
+#endif
+        for (; i < count; ++i) {
+          total += data[i] == value;
+        }
+        return total;
+      }
+    };
+
+    template <size_t _Bytes, bool _Greatest>
+    struct _extremum {
+      template <typename _T>
+      [[gnu::always_inline]] static _T run(const _T* data, size_t count) noexcept {
+        _T best = data[0];
+        size_t i = 1;
+#if defined(__GNUC__)
+        if constexpr (_vectorized<_T, _Bytes>) {
+          using _V = _vec<_T, _Bytes>;
+          constexpr size_t lanes = _Bytes / sizeof(_T);
+          if (count >= 2 * lanes) {
+            _V acc = _at<_Bytes>(data);
+            for (i = lanes; i + lanes <= count; i += lanes) {
+              _V x = _at<_Bytes>(data + i);
+              if constexpr (_Greatest) {
+                acc = x > acc ? x : acc;
+              }
+              else {
+                acc = x < acc ? x : acc;
+              }
+            }
+            best = acc[0];
+            for (size_t k = 1; k < lanes; ++k) {
+              best = _Greatest ? (acc[k] > best ? acc[k] : best) : (acc[k] < best ? acc[k] : best);
+            }
+          }
+        }
+#endif
+        for (; i < count; ++i) {
+          best = _Greatest ? (data[i] > best ? data[i] : best) : (data[i] < best ? data[i] : best);
+        }
+        return best;
+      }
+    };
+
+    template <size_t _Bytes>
+    using _min = _extremum<_Bytes, false>;
+
+    template <size_t _Bytes>
+    using _max = _extremum<_Bytes, true>;
+
+    template <size_t _Bytes>
+    struct _sum {
+      template <typename _T>
+      [[gnu::always_inline]] static accumulator_t<_T> run(const _T* data, size_t count) noexcept {
+        using _A = accumulator_t<_T>;
+        _A total = 0;
+        size_t i = 0;
+#if defined(__GNUC__)
+        if constexpr (_vectorized<_T, _Bytes>) {
+          constexpr size_t lanes = _Bytes / sizeof(_T);
+          using _AV = _vec<_A, lanes * sizeof(_A)>;
+          // Independent accumulators hide the add latency
+          _AV acc[4] = {};
+          for (; i + 4 * lanes <= count; i += 4 * lanes) {
+            for (size_t u = 0; u < 4; ++u) {
+              acc[u] += __builtin_convertvector(_at<_Bytes>(data + i + u * lanes), _AV);
+            }
+          }
+          for (; i + lanes <= count; i += lanes) {
+            acc[0] += __builtin_convertvector(_at<_Bytes>(data + i), _AV);
+          }
+          _AV all = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+          for (size_t k = 0; k < lanes; ++k) {
+            total += all[k];
+          }
+        }
+#endif
+        for (; i < count; ++i) {
+          total += data[i];
+        }
+        return total;
+      }
+    };
+
+    template <size_t _Bytes>
+    struct _dot {
+      template <typename _T>
+      [[gnu::always_inline]] static accumulator_t<_T> run(const _T* lhs, const _T* rhs, size_t count) noexcept {
+        using _A = accumulator_t<_T>;
+        _A total = 0;
+        size_t i = 0;
+#if defined(__GNUC__)
+        if constexpr (_vectorized<_T, _Bytes>) {
+          constexpr size_t lanes = _Bytes / sizeof(_T);
+          using _AV = _vec<_A, lanes * sizeof(_A)>;
+          _AV acc[4] = {};
+          for (; i + 4 * lanes <= count; i += 4 * lanes) {
+            for (size_t u = 0; u < 4; ++u) {
+              size_t at = i + u * lanes;
+              acc[u] += __builtin_convertvector(_at<_Bytes>(lhs + at), _AV) * __builtin_convertvector(_at<_Bytes>(rhs + at), _AV);
+            }
+          }
+          for (; i + lanes <= count; i += lanes) {
+            acc[0] += __builtin_convertvector(_at<_Bytes>(lhs + i), _AV) * __builtin_convertvector(_at<_Bytes>(rhs + i), _AV);
+          }
+          _AV all = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+          for (size_t k = 0; k < lanes; ++k) {
+            total += all[k];
+          }
+        }
+#endif
+        for (; i < count; ++i) {
+          total += _A(lhs[i]) * _A(rhs[i]);
+        }
+        return total;
+      }
+    };
+
+#if defined(JMK_SIMD_X86)
+    template <template <size_t> class _K, typename ... _Args>
+    JMK_SIMD_TARGET("avx512f,avx512bw,avx512vl,avx512dq") auto _run_avx512(_Args ... args) noexcept {
+      return _K<64>::run(args...);
+    }
+
+    template <template <size_t> class _K, typename ... _Args>
+    JMK_SIMD_TARGET("avx2") auto _run_avx2(_Args ... args) noexcept {
+      return _K<32>::run(args...);
+    }
+
+    template <template <size_t> class _K, typename ... _Args>
+    JMK_SIMD_TARGET("sse2") auto _run_sse2(_Args ... args) noexcept {
+      return _K<16>::run(args...);
+    }
+#endif
+
+    template <template <size_t> class _K, typename ... _Args>
+    auto _dispatch(_Args ... args) noexcept {
+#if defined(JMK_SIMD_X86)
+      switch (_active.load(std::memory_order_relaxed)) {
+        case isa::avx512:
+          return _run_avx512<_K>(args...);
+        case isa::avx2:
+          return _run_avx2<_K>(args...);
+        case isa::sse2:
+          return _run_sse2<_K>(args...);
+        default:
+          return _K<0>::run(args...);
+      }
+#elif defined(__GNUC__)
+      // Sixteen byte vectors are baseline on the other targets GCC vectorizes for
+      return _K<16>::run(args...);
+#else
+      return _K<0>::run(args...);
+#endif
+    }
+
+  }
+
+  // Widest instruction set this CPU supports
+  [[nodiscard]] inline isa detected_isa() noexcept {
+    return _detail::_detected;
+  }
+
+  // Instruction set the kernels currently run with
+  [[nodiscard]] inline isa active_isa() noexcept {
+    return _detail::_active.load(std::memory_order_relaxed);
+  }
+
+  // Restricts the kernels to level, or to what the CPU supports if that is
+  // narrower, and returns the level in effect. Meant for testing and
+  // benchmarking the narrower paths.
+  inline isa set_active_isa(isa level) noexcept {
+    isa applied = std::min(level, detected_isa());
+    _detail::_active.store(applied, std::memory_order_relaxed);
+    return applied;
+  }
+
+  template <arithmetic _T>
+  void fill(_T* data, size_t count, _T value) noexcept {
+    _detail::_dispatch<_detail::_fill>(data, count, value);
+  }
+
+  // Index of the first element equal to value, or count if there is none
+  template <arithmetic _T>
+  [[nodiscard]] size_t find(const _T* data, size_t count, _T value) noexcept {
+    return _detail::_dispatch<_detail::_find>(data, count, value);
+  }
+
+  template <arithmetic _T>
+  [[nodiscard]] bool contains(const _T* data, size_t count, _T value) noexcept {
+    return find(data, count, value) != count;
+  }
+
+  // Index of the first position where lhs and rhs differ, or count if none
+  template <arithmetic _T>
+  [[nodiscard]] size_t mismatch(const _T* lhs, const _T* rhs, size_t count) noexcept {
+    return _detail::_dispatch<_detail::_mismatch>(lhs, rhs, count);
+  }
+
+  template <arithmetic _T>
+  [[nodiscard]] size_t count(const _T* data, size_t count, _T value) noexcept {
+    return _detail::_dispatch<_detail::_count>(data, count, value);
+  }
+
+  // min, max, argmin and argmax need at least one element. Results involving
+  // NaN are unspecified.
+  template <arithmetic _T>
+  [[nodiscard]] _T min(const _T* data, size_t count) noexcept {
+    assert(count > 0);
+    return _detail::_dispatch<_detail::_min>(data, count);
+  }
+
+  template <arithmetic _T>
+  [[nodiscard]] _T max(const _T* data, size_t count) noexcept {
+    assert(count > 0);
+    return _detail::_dispatch<_detail::_max>(data, count);
+  }
+
+  // Index of the first smallest element
+  template <arithmetic _T>
+  [[nodiscard]] size_t argmin(const _T* data, size_t count) noexcept {
+    return find(data, count, min(data, count));
+  }
+
+  // Index of the first largest element
+  template <arithmetic _T>
+  [[nodiscard]] size_t argmax(const _T* data, size_t count) noexcept {
+    return find(data, count, max(data, count));
+  }
+
+  // Floating point sums are reassociated, so they can differ from a
+  // sequential loop in the last bits
+  template <arithmetic _T>
+  [[nodiscard]] accumulator_t<_T> sum(const _T* data, size_t count) noexcept {
+    return _detail::_dispatch<_detail::_sum>(data, count);
+  }
+
+  template <arithmetic _T>
+  [[nodiscard]] accumulator_t<_T> dot(const _T* lhs, const _T* rhs, size_t count) noexcept {
+    return _detail::_dispatch<_detail::_dot>(lhs, rhs, count);
+  }
+
+  template <contiguous _C>
+  void fill(_C& range, element_t<_C> value) noexcept {
+    fill(range.data(), range.size(), value);
+  }
+
+  template <contiguous _C>
+  [[nodiscard]] size_t find(const _C& range, element_t<_C> value) noexcept {
+    return find(range.data(), range.size(), value);
+  }
+
+  template <contiguous _C>
+  [[nodiscard]] bool contains(const _C& range, element_t<_C> value) noexcept {
+    return contains(range.data(), range.size(), value);
+  }
+
+  // Compares the common prefix of both ranges
+  template <contiguous _C, contiguous _D>
+    requires std::is_same_v<element_t<_C>, element_t<_D>>
+  [[nodiscard]] size_t mismatch(const _C& lhs, const _D& rhs) noexcept {
+    return mismatch(lhs.data(), rhs.data(), std::min<size_t>(lhs.size(), rhs.size()));
+  }
+
+  template <contiguous _C>
+  [[nodiscard]] size_t count(const _C& range, element_t<_C> value) noexcept {
+    return count(range.data(), range.size(), value);
+  }
+
+  template <contiguous _C>
+  [[nodiscard]] element_t<_C> min(const _C& range) noexcept {
+    return min(range.data(), range.size());
+  }
+
+  template <contiguous _C>
+  [[nodiscard]] element_t<_C> max(const _C& range) noexcept {
+    return max(range.data(), range.size());
+  }
+
+  template <contiguous _C>
+  [[nodiscard]] size_t argmin(const _C& range) noexcept {
+    return argmin(range.data(), range.size());
+  }
+
+  template <contiguous _C>
+  [[nodiscard]] size_t argmax(const _C& range) noexcept {
+    return argmax(range.data(), range.size());
+  }
+
+  template <contiguous _C>
+  [[nodiscard]] accumulator_t<element_t<_C>> sum(const _C& range) noexcept {
+    return sum(range.data(), range.size());
+  }
+
+  // Both ranges must have the same size
+  template <contiguous _C, contiguous _D>
+    requires std::is_same_v<element_t<_C>, element_t<_D>>
+  [[nodiscard]] accumulator_t<element_t<_C>> dot(const _C& lhs, const _D& rhs) noexcept {
+    assert(lhs.size() == rhs.size());
+    return dot(lhs.data(), rhs.data(), lhs.size());
+  }
+
+}
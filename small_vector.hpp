@@ -0,0 +1,545 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+
+#include "traits.hpp"
+#include "vector.hpp"
+
+namespace JMK {
+
+  // Vector that keeps up to _N elements in inline storage and only spills to
+  // the allocator once it grows past that.
+  template <typename _T, size_t _N, typename _Alloc = std::allocator<_T>>
+  class small_vector {
+  public:
+    static_assert(_N > 0, "JMK::small_vector inline capacity cannot be empty");
+
+    using iterator = typename JMK::vector<_T>::iterator;
+    using const_iterator = typename JMK::vector<_T>::const_iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    using allocator_type = _Alloc;
+
+    constexpr small_vector() noexcept(std::is_nothrow_default_constructible_v<_Alloc>) : m_alloc() {}
+
+    constexpr explicit small_vector(const _Alloc& alloc) noexcept : m_alloc(alloc) {}
+
+    constexpr small_vector(const small_vector& other) : m_growth_factor(other.m_growth_factor),
+      m_alloc(_alloc_traits::select_on_container_copy_construction(other.m_alloc)) {
+      _copy_from(other.m_data, other.m_size);
+    }
+
+    constexpr small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<_T>)
+      : m_growth_factor(other.m_growth_factor), m_alloc(std::move(other.m_alloc)) {
+      _move_from(std::move(other));
+    }
+
+    constexpr small_vector(_T _fill, size_t size, const _Alloc& alloc = _Alloc()) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) : m_alloc(alloc) {
+      resize(size);
+      fill(_fill);
+    }
+
+    constexpr small_vector(std::initializer_list<_T> list, const _Alloc& alloc = _Alloc()) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) : m_alloc(alloc) {
+      _copy_from(list.begin(), list.size());
+    }
+
+    constexpr ~small_vector() {
+      _destroy_range(0, m_size);
+      _deallocate_storage();
+    }
+
+    constexpr small_vector& operator=(const small_vector& other) {
+      if (this != &other) {
+        _destroy_range(0, m_size);
+        m_size = 0;
+        _copy_from(other.m_data, other.m_size);
+      }
+      return *this;
+    }
+
+    constexpr small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      if (this != &other) {
+        _destroy_range(0, m_size);
+        m_size = 0;
+        if constexpr (!_alloc_traits::propagate_on_container_move_assignment::value &&
+          !_alloc_traits::is_always_equal::value) {
+          // A heap buffer owned by a foreign allocator cannot be adopted, move element-wise
+          if (m_alloc != other.m_alloc) {
+            _reserve_impl(other.m_size);
+            for (size_t i = 0; i < other.m_size; ++i) {
+              _construct_at(&m_data[i], std::move(other.m_data[i]));
+            }
+            m_size = other.m_size;
+            return *this;
+          }
+        }
+        _deallocate_storage();
+        if constexpr (_alloc_traits::propagate_on_container_move_assignment::value) {
+          m_alloc = std::move(other.m_alloc);
+        }
+        m_growth_factor = other.m_growth_factor;
+        _move_from(std::move(other));
+      }
+      return *this;
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept { return m_alloc; }
+
+    [[nodiscard]] constexpr size_t size() const noexcept { return m_size; }
+    [[nodiscard]] constexpr size_t max_size() const noexcept { return std::numeric_limits<size_t>::max(); }
+    [[nodiscard]] constexpr size_t capacity() const noexcept { return m_capacity; }
+    [[nodiscard]] static constexpr size_t inline_capacity() noexcept { return _N; }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+    [[nodiscard]] constexpr bool is_inline() const noexcept { return m_data == _inline_data(); }
+
+    [[nodiscard]] _T& at(size_t index) {
+      assert(index < size());
+      return m_data[index];
+    }
+
+    [[nodiscard]] const _T& at(size_t index) const {
+      assert(index < size());
+      return m_data[index];
+    }
+
+    [[nodiscard]] constexpr _T& operator[](size_t index) noexcept {
+      return m_data[index];
+    }
+
+    [[nodiscard]] constexpr const _T& operator[](size_t index) const noexcept {
+      return m_data[index];
+    }
+
+    [[nodiscard]] constexpr _T& front() noexcept { return m_data[0]; }
+    [[nodiscard]] constexpr const _T& front() const noexcept { return m_data[0]; }
+
+    [[nodiscard]] constexpr _T& back() noexcept { return m_data[m_size - 1]; }
+    [[nodiscard]] constexpr const _T& back() const noexcept { return m_data[m_size - 1]; }
+
+    [[nodiscard]] constexpr _T* data() noexcept { return m_data; }
+    [[nodiscard]] constexpr const _T* data() const noexcept { return m_data; }
+
+    void resize(size_t new_size) {
+      _grow_to(new_size);
+      for (size_t i = m_size; i < new_size; ++i) {
+        _construct_at(&m_data[i]);
+      }
+      _destroy_range(new_size, m_size);
+      m_size = new_size;
+    }
+
+    void resize_default_init(size_t new_size) {
+      _resize_default_init_impl(new_size);
+    }
+
+    void resize_uninitialized(size_t new_size) {
+      static_assert(std::is_trivially_default_constructible_v<_T> && std::is_trivially_destructible_v<_T>,
+        "JMK::small_vector::resize_uninitialized requires a trivial element type");
+      _resize_default_init_impl(new_size);
+    }
+
+    template <typename _Fn>
+    size_t append_with(size_t count, _Fn&& callback) {
+      size_t offset = m_size;
+      _resize_default_init_impl(m_size + count);
+      std::span<_T> region(m_data + offset, count);
+      if constexpr (std::is_void_v<std::invoke_result_t<_Fn, std::span<_T>>>) {
+        std::invoke(std::forward<_Fn>(callback), region);
+        return count;
+      }
+      else {
+        size_t written = std::min<size_t>(std::invoke(std::forward<_Fn>(callback), region), count);
+        _destroy_range(offset + written, m_size);
+        m_size = offset + written;
+        return written;
+      }
+    }
+
+    void reserve(size_t new_capacity) {
+      _reserve_impl(new_capacity);
+    }
+
+    // Moves the elements back inline when they fit again
+    void shrink_to_fit() {
+      if (is_inline() || m_size > _N) {
+        return;
+      }
+      _T* heap = m_data;
+      size_t heap_capacity = m_capacity;
+      _relocate(_inline_data(), heap, m_size);
+      _alloc_traits::deallocate(m_alloc, heap, heap_capacity);
+      m_data = _inline_data();
+      m_capacity = _N;
+    }
+
+    void set_growth_factor(float factor) {
+      m_growth_factor = std::max(factor, 1.1f);
+    }
+
+    [[nodiscard]] constexpr iterator begin() noexcept { return m_data; }
+    [[nodiscard]] constexpr iterator end() noexcept { return m_data + m_size; }
+    [[nodiscard]] constexpr const_iterator begin() const noexcept { return m_data; }
+    [[nodiscard]] constexpr const_iterator end() const noexcept { return m_data + m_size; }
+
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return m_data; }
+    [[nodiscard]] constexpr const_iterator cend() const noexcept { return m_data + m_size; }
+
+    [[nodiscard]] constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    [[nodiscard]] constexpr reverse_const_iterator crbegin() const noexcept { return reverse_const_iterator(cend()); }
+    [[nodiscard]] constexpr reverse_const_iterator crend() const noexcept { return reverse_const_iterator(cbegin()); }
+
+    template <typename ... _Args>
+    constexpr void emplace_back(_Args&& ... args) noexcept(std::is_trivially_constructible_v<_T>) {
+      if (m_size >= m_capacity) {
+        // Built before growing in case the arguments alias an element
+        _T value(std::forward<_Args>(args)...);
+        _reserve_impl(_next_capacity());
+        _construct_at(&m_data[m_size], std::move(value));
+      }
+      else {
+        _construct_at(&m_data[m_size], std::forward<_Args>(args)...);
+      }
+      m_size += 1;
+    }
+
+    constexpr void push_back(const _T& value) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) {
+      emplace_back(value);
+    }
+
+    constexpr void push_back(_T&& value) noexcept(std::is_trivially_move_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) {
+      emplace_back(std::move(value));
+    }
+
+    constexpr _T pop_back() noexcept(std::is_trivially_copy_assignable_v<_T>&& std::is_trivially_constructible_v<_T>) {
+      assert(m_size > 0);
+      _T value = std::move(m_data[--m_size]);
+      _destroy_at(&m_data[m_size]);
+      return value;
+    }
+
+    template <typename ... _Args>
+    constexpr iterator emplace(const_iterator pos, _Args&& ... args) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_constructible_v<_T>) {
+      size_t index = static_cast<size_t>(pos - cbegin());
+      // Built up front in case the arguments alias an element that moves
+      _T value(std::forward<_Args>(args)...);
+      _T* gap = _open_gap(index, 1);
+      _construct_at(gap, std::move(value));
+      return gap;
+    }
+
+    constexpr iterator insert(const_iterator pos, const _T& value) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) {
+      return emplace(pos, value);
+    }
+
+    constexpr iterator insert(const_iterator pos, size_t count, const _T& value) {
+      size_t index = static_cast<size_t>(pos - cbegin());
+      if (count == 0) {
+        return m_data + index;
+      }
+      _T copy(value);
+      _T* gap = _open_gap(index, count);
+      for (size_t i = 0; i < count; ++i) {
+        _construct_at(&gap[i], copy);
+      }
+      return gap;
+    }
+
+    template <std::input_iterator _It>
+    constexpr iterator insert(const_iterator pos, _It first, _It last) {
+      return _insert_range(static_cast<size_t>(pos - cbegin()), std::move(first), std::move(last));
+    }
+
+    constexpr iterator insert(const_iterator pos, std::initializer_list<_T> list) {
+      return _insert_range(static_cast<size_t>(pos - cbegin()), list.begin(), list.end());
+    }
+
+    template <std::ranges::input_range _Range>
+    constexpr void append_range(_Range&& range) {
+      _insert_range(m_size, std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    constexpr iterator erase(iterator pos) noexcept(std::is_trivially_destructible_v<_T>) {
+      return erase(pos, pos + 1);
+    }
+
+    constexpr iterator erase(iterator _beg, iterator _end) noexcept(std::is_trivially_destructible_v<_T>) {
+      size_t first = static_cast<size_t>(_beg - begin());
+      size_t last = static_cast<size_t>(_end - begin());
+      if (first == last) {
+        return _beg;
+      }
+      if constexpr (std::is_pointer_v<_T>) {
+        for (size_t i = first; i < last; ++i) {
+          delete m_data[i];
+        }
+      }
+      for (size_t i = last; i < m_size; ++i) {
+        m_data[i - (last - first)] = std::move(m_data[i]);
+      }
+      _destroy_range(m_size - (last - first), m_size);
+      m_size -= last - first;
+      return _beg;
+    }
+
+    constexpr void clear() noexcept(std::is_trivially_copy_assignable_v<_T>&& std::is_trivially_constructible_v<_T>) {
+      erase(begin(), end());
+    }
+
+    [[nodiscard]] constexpr bool operator==(const small_vector& other) const requires std::equality_comparable<_T> {
+      return JMK::equal_ranges(data(), size(), other.data(), other.size());
+    }
+
+    [[nodiscard]] constexpr auto operator<=>(const small_vector& other) const requires std::three_way_comparable<_T> {
+      return JMK::compare_ranges(data(), size(), other.data(), other.size());
+    }
+
+    constexpr void fill(_T v) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) {
+      if constexpr (JMK::simd::arithmetic<_T>) {
+        if (!std::is_constant_evaluated()) {
+          JMK::simd::fill(m_data, size(), v);
+          return;
+        }
+      }
+      for (size_t i = 0; i < size(); ++i) {
+        m_data[i] = v;
+      }
+    }
+
+    constexpr void reset() noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) {
+      fill(_T());
+    }
+
+  private:
+    using _alloc_traits = std::allocator_traits<_Alloc>;
+
+    [[nodiscard]] constexpr _T* _inline_data() noexcept { return reinterpret_cast<_T*>(m_inline); }
+    [[nodiscard]] constexpr const _T* _inline_data() const noexcept { return reinterpret_cast<const _T*>(m_inline); }
+
+    [[nodiscard]] constexpr size_t _next_capacity() const noexcept {
+      return std::max(static_cast<size_t>(m_capacity * m_growth_factor), m_capacity + 1);
+    }
+
+    constexpr void _resize_default_init_impl(size_t new_size) {
+      _grow_to(new_size);
+      if constexpr (!std::is_trivially_default_constructible_v<_T>) {
+        for (size_t i = m_size; i < new_size; ++i) {
+          ::new(static_cast<void*>(&m_data[i])) _T;
+        }
+      }
+      _destroy_range(new_size, m_size);
+      m_size = new_size;
+    }
+
+    constexpr void _grow_to(size_t new_size) {
+      if (new_size <= m_capacity) {
+        return;
+      }
+      size_t new_capacity = m_capacity;
+      while (new_capacity < new_size) {
+        new_capacity = std::max(static_cast<size_t>(new_capacity * m_growth_factor), new_capacity + 1);
+      }
+      _reserve_impl(new_capacity);
+    }
+
+    // Opens count raw slots at index and returns them. The tail is relocated
+    // exactly once, straight into the new block when the vector has to grow.
+    constexpr _T* _open_gap(size_t index, size_t count) {
+      if (m_size + count > m_capacity) {
+        size_t new_capacity = m_capacity;
+        while (new_capacity < m_size + count) {
+          new_capacity = std::max(static_cast<size_t>(new_capacity * m_growth_factor), new_capacity + 1);
+        }
+        _T* new_data = _alloc_traits::allocate(m_alloc, new_capacity);
+        _relocate(new_data, m_data, index);
+        _relocate(new_data + index + count, m_data + index, m_size - index);
+        _deallocate_storage();
+        m_data = new_data;
+        m_capacity = new_capacity;
+      }
+      else {
+        _relocate_backward(m_data + index + count, m_data + index, m_size - index);
+      }
+      m_size += count;
+      return m_data + index;
+    }
+
+    constexpr void _reserve_impl(size_t new_capacity) {
+      if (new_capacity <= m_capacity) {
+        return;
+      }
+
+      if constexpr (JMK::is_trivially_relocatable_v<_T> && JMK::reallocating_allocator<_Alloc>) {
+        if (!is_inline()) {
+          m_data = m_alloc.reallocate(m_data, m_capacity, new_capacity);
+          m_capacity = new_capacity;
+          return;
+        }
+      }
+
+      _T* new_data = _alloc_traits::allocate(m_alloc, new_capacity);
+      _relocate(new_data, m_data, m_size);
+      _deallocate_storage();
+      m_data = new_data;
+      m_capacity = new_capacity;
+    }
+
+    constexpr void _relocate(_T* dst, _T* src, size_t count) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      if (count == 0) {
+        return;
+      }
+      if constexpr (JMK::is_trivially_relocatable_v<_T>) {
+        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(_T));
+      }
+      else {
+        for (size_t i = 0; i < count; ++i) {
+          _construct_at(&dst[i], std::move_if_noexcept(src[i]));
+          _destroy_at(&src[i]);
+        }
+      }
+    }
+
+    // Relocates to a higher, possibly overlapping address, back to front
+    constexpr void _relocate_backward(_T* dst, _T* src, size_t count) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      if (count == 0) {
+        return;
+      }
+      if constexpr (JMK::is_trivially_relocatable_v<_T>) {
+        std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(_T));
+      }
+      else {
+        for (size_t i = count; i > 0; --i) {
+          _construct_at(&dst[i - 1], std::move_if_noexcept(src[i - 1]));
+          _destroy_at(&src[i - 1]);
+        }
+      }
+    }
+
+    template <typename _It, typename _Sent>
+    constexpr iterator _insert_range(size_t index, _It first, _Sent last) {
+      if constexpr (std::forward_iterator<_It>) {
+        size_t count = static_cast<size_t>(std::ranges::distance(first, last));
+        if (count == 0) {
+          return m_data + index;
+        }
+        _T* gap = _open_gap(index, count);
+        for (size_t i = 0; i < count; ++i, ++first) {
+          _construct_at(&gap[i], *first);
+        }
+        return gap;
+      }
+      else {
+        // Single pass input, so the length is unknown until it is consumed
+        size_t old_size = m_size;
+        for (; first != last; ++first) {
+          emplace_back(*first);
+        }
+        std::rotate(m_data + index, m_data + old_size, m_data + m_size);
+        return m_data + index;
+      }
+    }
+
+    template <typename _Ptr>
+    constexpr void _copy_from(_Ptr src, size_t count) {
+      _reserve_impl(count);
+      for (size_t i = 0; i < count; ++i) {
+        _construct_at(&m_data[i], src[i]);
+      }
+      m_size = count;
+    }
+
+    constexpr void _move_from(small_vector&& other) {
+      if (other.is_inline()) {
+        _relocate(m_data, other.m_data, other.m_size);
+      }
+      else {
+        m_data = other.m_data;
+        m_capacity = other.m_capacity;
+        other.m_data = other._inline_data();
+        other.m_capacity = _N;
+      }
+      m_size = other.m_size;
+      other.m_size = 0;
+    }
+
+    template <typename ... _Args>
+    constexpr void _construct_at(_T* ptr, _Args&&... value) noexcept(std::is_trivially_constructible_v<_T>) {
+      _alloc_traits::construct(m_alloc, ptr, std::forward<_Args>(value)...);
+    }
+
+    constexpr void _destroy_at(_T* ptr) noexcept {
+      _alloc_traits::destroy(m_alloc, ptr);
+    }
+
+    constexpr void _destroy_range(size_t first, size_t last) noexcept {
+      if constexpr (!std::is_trivially_destructible_v<_T>) {
+        for (size_t i = first; i < last; ++i) {
+          _destroy_at(&m_data[i]);
+        }
+      }
+    }
+
+    constexpr void _deallocate_storage() noexcept {
+      if (!is_inline()) {
+        _alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+      }
+      m_data = _inline_data();
+      m_capacity = _N;
+    }
+
+    _T* m_data = _inline_data();
+    size_t m_size = 0;
+    size_t m_capacity = _N;
+    float m_growth_factor = 1.5f;
+    [[no_unique_address]] _Alloc m_alloc;
+    alignas(_T) std::byte m_inline[_N * sizeof(_T)];
+  };
+
+}
+
+namespace JMK {
+
+  template <typename _T, size_t _N, typename _Alloc>
+  inline std::ostream& operator<<(std::ostream& os, const JMK::small_vector<_T, _N, _Alloc>& arr) {
+    os << "[";
+    for (size_t i = 0; i < arr.size(); ++i) {
+      os << arr[i];
+      if (i < arr.size() - 1) {
+        os << ", ";
+      }
+    }
+    os << "]";
+    return os;
+  }
+
+}
+
+template <typename _T, size_t _N, typename _Alloc>
+  requires JMK::range_hashable<_T>
+struct std::hash<JMK::small_vector<_T, _N, _Alloc>> {
+  [[nodiscard]] size_t operator()(const JMK::small_vector<_T, _N, _Alloc>& value) const noexcept {
+    return JMK::hash_range(value.data(), value.size());
+  }
+};
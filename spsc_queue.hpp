@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+#include "array.hpp"
+#include "traits.hpp"
+
+namespace JMK {
+
+  // Wait-free single-producer/single-consumer ring over the same fixed
+  // storage as queue<_T, _N>. Exactly one thread may enqueue and exactly one
+  // thread may dequeue at a time. The capacity is a power of two so the
+  // free-running indices map to slots with a mask and stay continuous when
+  // they wrap around size_t.
+  template <typename _T, size_t _N>
+  class spsc_queue {
+  public:
+    static_assert(_N > 0 && (_N & (_N - 1)) == 0, "JMK::spsc_queue capacity must be a power of two");
+
+    spsc_queue() = default;
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    [[nodiscard]] static constexpr size_t capacity() noexcept { return _N; }
+    [[nodiscard]] static constexpr size_t max_size() noexcept { return _N; }
+
+    // Approximate when called while either side is active. Head is read
+    // first so tail can only be newer, never behind it; the consumer may
+    // still have moved on in between, hence the clamp.
+    [[nodiscard]] size_t size() const noexcept {
+      size_t head = m_head.load(std::memory_order_acquire);
+      size_t tail = m_tail.load(std::memory_order_acquire);
+      return std::min(tail - head, _N);
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    // Producer side
+    template <typename ... _Args>
+    bool try_emplace(_Args&& ... args) noexcept(std::is_nothrow_constructible_v<_T, _Args...>&&
+      std::is_nothrow_move_assignable_v<_T>) {
+      size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (tail - m_cached_head >= _N) {
+        m_cached_head = m_head.load(std::memory_order_acquire);
+        if (tail - m_cached_head >= _N) {
+          return false;
+        }
+      }
+      m_data[tail & _mask] = _T(std::forward<_Args>(args)...);
+      m_tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    bool try_enqueue(const _T& item) noexcept(std::is_nothrow_copy_assignable_v<_T>) {
+      return try_emplace(item);
+    }
+
+    bool try_enqueue(_T&& item) noexcept(std::is_nothrow_move_assignable_v<_T>) {
+      return try_emplace(std::move(item));
+    }
+
+    void enqueue(const _T& item) {
+      while (!try_enqueue(item)) {
+        std::this_thread::yield();
+      }
+    }
+
+    void enqueue(_T&& item) {
+      while (!try_enqueue(std::move(item))) {
+        std::this_thread::yield();
+      }
+    }
+
+    // Consumer side
+    bool try_dequeue(_T& out) noexcept(std::is_nothrow_move_assignable_v<_T>) {
+      size_t head = m_head.load(std::memory_order_relaxed);
+      if (head == m_cached_tail) {
+        m_cached_tail = m_tail.load(std::memory_order_acquire);
+        if (head == m_cached_tail) {
+          return false;
+        }
+      }
+      out = std::move(m_data[head & _mask]);
+      m_head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    _T dequeue() {
+      _T out;
+      while (!try_dequeue(out)) {
+        std::this_thread::yield();
+      }
+      return out;
+    }
+
+    // Returns the oldest element without removing it, or nullptr if empty.
+    // Only valid on the consumer thread until the next pop()
+    [[nodiscard]] _T* front() noexcept {
+      size_t head = m_head.load(std::memory_order_relaxed);
+      if (head == m_cached_tail) {
+        m_cached_tail = m_tail.load(std::memory_order_acquire);
+        if (head == m_cached_tail) {
+          return nullptr;
+        }
+      }
+      return &m_data[head & _mask];
+    }
+
+    void pop() noexcept {
+      size_t head = m_head.load(std::memory_order_relaxed);
+      assert(head != m_tail.load(std::memory_order_acquire));
+      m_head.store(head + 1, std::memory_order_release);
+    }
+
+  private:
+    static constexpr size_t _mask = _N - 1;
+
+    // Consumer owned line: its index plus its snapshot of the producer's
+    alignas(JMK::cache_line_size) std::atomic<size_t> m_head = 0;
+    size_t m_cached_tail = 0;
+
+    // Producer owned line: its index plus its snapshot of the consumer's
+    alignas(JMK::cache_line_size) std::atomic<size_t> m_tail = 0;
+    size_t m_cached_head = 0;
+
+    alignas(JMK::cache_line_size) JMK::array<_T, _N> m_data;
+  };
+
+}
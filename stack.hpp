@@ -5,19 +5,21 @@
 #include <initializer_list>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 
 #include "array.hpp"
+#include "deque.hpp"
 #include "vector.hpp"
 
 namespace JMK {
 
-  template <typename _T, size_t _N>
+  template <typename _T, size_t _N, typename _Alloc = std::allocator<_T>>
   class stack {
   public:
     constexpr stack() = default;
 
     template <typename _U, size_t _S>
-    constexpr stack(const JMK::stack<_U, _S>& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr stack(const JMK::stack<_U, _S>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_copy_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) {
@@ -28,7 +30,7 @@ namespace JMK {
     }
 
     template <typename _U, size_t _S>
-    constexpr stack(JMK::stack<_U, _S>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr stack(JMK::stack<_U, _S>&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_move_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) {
@@ -42,13 +44,13 @@ namespace JMK {
       std::is_trivially_constructible_v<_T>) : m_data(list), m_size(list.size()) {}
 
     template <typename _U, size_t _S>
-    constexpr stack(const JMK::array<_U, _S>& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr stack(const JMK::array<_U, _S>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_copy_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) : m_data(other), m_size(other.size()) {}
 
     template <typename _U, size_t _S>
-    constexpr stack(JMK::array<_U, _S>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr stack(JMK::array<_U, _S>&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_move_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) : m_data(std::move(other)), m_size(other.size()) {}
@@ -85,17 +87,21 @@ namespace JMK {
 
   private:
     JMK::array<_T, _N> m_data;
-    size_t m_size = 0
+    size_t m_size = 0;
   };
 
 
-  template <typename _T>
-  class stack<_T, 0> {
+  template <typename _T, typename _Alloc>
+  class stack<_T, 0, _Alloc> {
   public:
+    using allocator_type = _Alloc;
+
     constexpr stack() = default;
 
+    constexpr explicit stack(const _Alloc& alloc) noexcept : m_data(alloc) {}
+
     template <typename _U, size_t _S>
-    constexpr stack(const JMK::stack<_U, _S>& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr stack(const JMK::stack<_U, _S>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_copy_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) {
@@ -106,7 +112,7 @@ namespace JMK {
     }
 
     template <typename _U, size_t _S>
-    constexpr stack(JMK::stack<_U, _S>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr stack(JMK::stack<_U, _S>&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_move_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) {
@@ -120,13 +126,13 @@ namespace JMK {
       std::is_trivially_constructible_v<_T>) : m_data(list) {}
 
     template <typename _U, size_t _S>
-    constexpr stack(const JMK::array<_U, _S>& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr stack(const JMK::array<_U, _S>& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_copy_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) : m_data(other) {}
 
     template <typename _U, size_t _S>
-    constexpr stack(JMK::array<_U, _S>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    constexpr stack(JMK::array<_U, _S>&& other) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_move_assignable_v<_U>&&
       std::is_trivially_constructible_v<_U>) : m_data(std::move(other)) {}
@@ -164,21 +170,78 @@ namespace JMK {
       m_data.clear();
     }
 
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_data.get_allocator(); }
+
+    // Friend declaration for the stream operator
+    template <typename _Ty, size_t _S, typename _TyAlloc>
+    friend std::ostream& operator<<(std::ostream& os, const JMK::stack<_Ty, _S, _TyAlloc>& obj);
+
+  private:
+    JMK::vector<_T, _Alloc> m_data;
+  };
+
+
+  // Backed by JMK::deque, so pushing never relocates the existing elements
+  template <typename _T, typename _Alloc>
+  class stack<_T, segmented_extent, _Alloc> {
+  public:
+    using allocator_type = _Alloc;
+
+    stack() = default;
+
+    explicit stack(const _Alloc& alloc) noexcept : m_data(alloc) {}
+
+    stack(std::initializer_list<_T> list) : m_data(list) {}
+
+    [[nodiscard]] size_t size() const noexcept { return m_data.size(); }
+    [[nodiscard]] size_t max_size() const noexcept { return m_data.max_size(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_data.empty(); }
+
+    [[nodiscard]] _T& top() noexcept {
+      assert(size() != 0);
+      return m_data.back();
+    }
+
+    [[nodiscard]] const _T& top() const noexcept {
+      assert(size() != 0);
+      return m_data.back();
+    }
+
+    void push(const _T& item) {
+      m_data.push_back(item);
+    }
+
+    void push(_T&& item) {
+      m_data.push_back(std::move(item));
+    }
+
+    _T pop() {
+      assert(size() != 0);
+      return m_data.pop_back();
+    }
+
+    void clear() noexcept {
+      m_data.clear();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_data.get_allocator(); }
+
     // Friend declaration for the stream operator
-    template <typename _Ty, size_t _S>
-    friend std::ostream& operator<<(std::ostream& os, const JMK::stack<_Ty, _S>& obj);
+    template <typename _Ty, size_t _S, typename _TyAlloc>
+    friend std::ostream& operator<<(std::ostream& os, const JMK::stack<_Ty, _S, _TyAlloc>& obj);
 
   private:
-    JMK::vector<_T> m_data;
+    JMK::deque<_T, _Alloc> m_data;
   };
 
 }
 
 namespace JMK {
 
-  template <typename _T, size_t _N>
-  inline std::ostream& operator<<(std::ostream& os, const JMK::stack<_T, _N>& obj) {
-    JMK::stack<_T, _N> copy(obj);
+  template <typename _T, size_t _N, typename _Alloc>
+  inline std::ostream& operator<<(std::ostream& os, const JMK::stack<_T, _N, _Alloc>& obj) {
+    JMK::stack<_T, _N, _Alloc> copy(obj);
 
     os << "+" << std::string(13, ' ') << "+" << std::endl;
     while (!copy.empty()) {
@@ -0,0 +1,108 @@
+// Tests that JMK::list splice and merge only relink nodes, between lists on
+// different node pools, and that every pool lives exactly as long as its
+// nodes do.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O1 -g -fsanitize=address -I.. list.cpp -o list
+//
+// and run ./list. Global operator new is counted, so a splice or merge that
+// allocates is a failure; a pool freed under a node that still lives in
+// another list shows up as a sanitizer report, and a pool kept alive after
+// its last node as a leak. The exit status is 1 on failure.
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "../list.hpp"
+
+namespace {
+
+  size_t s_allocations = 0;
+  size_t s_failures = 0;
+
+  void check(bool ok, const char* what) {
+    if (!ok) {
+      std::fprintf(stderr, "list: %s\n", what);
+      ++s_failures;
+    }
+  }
+
+  void splice_without_allocating() {
+    JMK::list<std::string> a, b;
+    for (int i = 0; i < 50; ++i) {
+      a.push_back("a" + std::to_string(i));
+      b.push_back("b" + std::to_string(i));
+    }
+    size_t before = s_allocations;
+    for (int i = 0; i < 2500; ++i) {
+      if (i % 2 == 0) {
+        b.splice(b.begin(), a, a.begin());
+      }
+      else {
+        a.splice(a.end(), b, b.begin());
+      }
+    }
+    check(s_allocations == before, "single node splices allocated");
+    check(a.size() + b.size() == 100, "splices lost nodes");
+
+    JMK::list<int> x{ 1, 4, 7 }, y{ 2, 3, 9 };
+    before = s_allocations;
+    x.merge(y);
+    check(s_allocations == before, "merge allocated");
+    check(y.empty() && x.size() == 6, "merge lost nodes");
+  }
+
+  void pools_follow_their_nodes() {
+    std::weak_ptr<JMK::list<std::string>::node_pool> pool;
+    JMK::list<std::string> keeper;
+    {
+      JMK::list<std::string> source{ "one", "two", "three" };
+      pool = source.get_node_pool();
+      keeper.splice(keeper.end(), source, source.begin());
+    }
+    check(!pool.expired(), "pool freed while one of its nodes was alive");
+    check(keeper.front() == "one", "spliced node was corrupted");
+    keeper.clear();
+    check(pool.expired(), "pool outlived its last node");
+
+    // Nodes of many short-lived lists, all kept by one long-lived list
+    for (int round = 0; round < 100; ++round) {
+      {
+        JMK::list<std::string> source{ std::to_string(round) };
+        pool = source.get_node_pool();
+        keeper.splice(keeper.end(), source);
+      }
+      check(!pool.expired(), "pool freed while one of its nodes was alive");
+      keeper.erase(keeper.begin());
+      check(pool.expired(), "pool outlived its last node");
+    }
+  }
+
+}
+
+void* operator new(size_t size) {
+  ++s_allocations;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+int main() {
+  splice_without_allocating();
+  pools_follow_their_nodes();
+  std::printf("list: %s\n", s_failures == 0 ? "ok" : "FAILED");
+  return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// Tests JMK::mpmc_queue with element types that are only movable, that
+// cannot be default constructed, or whose move constructor throws.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O1 -g -fsanitize=thread -I.. mpmc_queue.cpp -o mpmc_queue -pthread
+//
+// (or -fsanitize=address for leak and use-after-free reports) and run
+// ./mpmc_queue. Producers and consumers pass std::unique_ptr elements through
+// a small queue; every pointer must arrive exactly once and nothing may leak,
+// including elements still queued when the queue is destroyed. The exit
+// status is 1 on failure.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../mpmc_queue.hpp"
+
+namespace {
+
+  constexpr size_t producer_count = 3;
+  constexpr size_t consumer_count = 3;
+  constexpr uint64_t items_per_producer = 50000;
+
+  std::atomic<long> s_live = 0;
+  size_t s_failures = 0;
+
+  void check(bool ok, const char* what) {
+    if (!ok) {
+      std::fprintf(stderr, "mpmc_queue: %s\n", what);
+      ++s_failures;
+    }
+  }
+
+  struct counted {
+    explicit counted(uint64_t value) noexcept : m_value(value) { s_live.fetch_add(1, std::memory_order_relaxed); }
+    ~counted() { s_live.fetch_sub(1, std::memory_order_relaxed); }
+
+    uint64_t m_value;
+  };
+
+  // No default constructor, and moves throw on demand
+  struct fragile {
+    explicit fragile(int value) noexcept : m_value(value) {}
+    fragile(fragile&& other) : m_value(other.m_value) {
+      if (s_throw_on_move) {
+        throw std::runtime_error("move");
+      }
+    }
+    fragile& operator=(fragile&&) = default;
+
+    static inline bool s_throw_on_move = false;
+    int m_value;
+  };
+
+  void move_only_threads() {
+    using item = std::unique_ptr<counted>;
+    JMK::mpmc_queue<item, 16> queue;
+    std::atomic<uint64_t> sum = 0;
+    std::atomic<uint64_t> received = 0;
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producer_count; ++p) {
+      threads.emplace_back([&] {
+        for (uint64_t i = 1; i <= items_per_producer; ++i) {
+          queue.enqueue(std::make_unique<counted>(i));
+        }
+      });
+    }
+    for (size_t c = 0; c < consumer_count; ++c) {
+      threads.emplace_back([&, c] {
+        item out;
+        while (received.fetch_add(1, std::memory_order_relaxed) < producer_count * items_per_producer) {
+          if (c % 2 == 0) {
+            out = queue.dequeue();
+          }
+          else {
+            while (!queue.try_dequeue(out)) {
+              std::this_thread::yield();
+            }
+          }
+          sum.fetch_add(out->m_value, std::memory_order_relaxed);
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    check(sum.load() == producer_count * items_per_producer * (items_per_producer + 1) / 2, "elements lost or duplicated");
+    check(s_live.load() == 0, "dequeued elements leaked");
+
+    // A full queue leaves the rvalue alone, and queued elements die with it
+    {
+      JMK::mpmc_queue<item, 4> full;
+      for (uint64_t i = 0; i < 4; ++i) {
+        check(full.try_emplace(std::make_unique<counted>(i)), "enqueue into a queue with room failed");
+      }
+      item extra = std::make_unique<counted>(4);
+      check(!full.try_enqueue(std::move(extra)), "enqueue into a full queue succeeded");
+      check(extra != nullptr, "a failed enqueue consumed its element");
+    }
+    check(s_live.load() == 0, "elements left in the queue leaked");
+  }
+
+  void throwing_moves() {
+    JMK::mpmc_queue<fragile, 4> queue;
+    check(queue.try_emplace(1), "emplace failed");
+    fragile second(2);
+    fragile::s_throw_on_move = true;
+    bool thrown = false;
+    try {
+      queue.enqueue(std::move(second));
+    }
+    catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    fragile::s_throw_on_move = false;
+    check(thrown, "a throwing move was swallowed");
+    check(queue.try_emplace(3), "the queue stalled behind a failed enqueue");
+    check(queue.dequeue().m_value == 1, "wrong first element");
+    check(queue.dequeue().m_value == 3, "the failed element was not skipped");
+    fragile out(0);
+    check(!queue.try_dequeue(out), "queue not empty");
+    for (int i = 0; i < 4; ++i) {
+      check(queue.try_emplace(i), "a skipped cell was not handed back");
+    }
+  }
+
+}
+
+int main() {
+  move_only_threads();
+  throwing_moves();
+  std::printf("mpmc_queue: %s\n", s_failures == 0 ? "ok" : "FAILED");
+  return s_failures == 0 ? 0 : 1;
+}
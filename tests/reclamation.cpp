@@ -0,0 +1,132 @@
+// Multi-threaded stress test for JMK::reclamation_domain in both modes.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O1 -g -fsanitize=thread -I.. reclamation.cpp -o reclamation -pthread
+//
+// (or -fsanitize=address for use-after-free reports) and run ./reclamation
+// [SECONDS]. Writers keep swapping the nodes of a few shared slots and retire
+// the ones they replace while readers protect and read them, some through
+// nested guards. A reader that sees a destroyed node, a node still alive
+// after its domain is gone, or a sanitizer report is a failure. The exit
+// status is 1 on failure.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "../reclamation.hpp"
+
+namespace {
+
+  constexpr uint64_t alive = 0x600dc0de600dc0deu;
+  constexpr uint64_t dead = 0xdeadbeefdeadbeefu;
+  constexpr size_t slot_count = 4;
+  constexpr size_t reader_count = 4;
+  constexpr size_t writer_count = 2;
+
+  std::atomic<long> s_live = 0;
+  std::atomic<size_t> s_failures = 0;
+
+  struct node {
+    explicit node(uint64_t value) noexcept : m_value(value) { s_live.fetch_add(1, std::memory_order_relaxed); }
+
+    ~node() {
+      m_canary.store(dead, std::memory_order_relaxed);
+      s_live.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> m_canary = alive;
+    uint64_t m_value;
+  };
+
+  void check(bool ok, const char* what) {
+    if (!ok) {
+      std::fprintf(stderr, "reclamation: %s\n", what);
+      s_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  [[nodiscard]] bool readable(const node* n) noexcept {
+    return n != nullptr && n->m_canary.load(std::memory_order_relaxed) == alive;
+  }
+
+  void reader(JMK::reclamation_domain& domain, std::atomic<node*>* slots, const std::atomic<bool>& stop, size_t id) {
+    using guard = JMK::reclamation_domain::guard;
+    uint64_t round = id;
+    while (!stop.load(std::memory_order_relaxed)) {
+      guard outer(domain);
+      node* first = outer.protect(slots[round % slot_count], 0);
+      check(readable(first), "protected node was freed");
+      {
+        // Nested guards share the thread's hazard slots, so this one uses
+        // another; leaving it must not drop the outer protection
+        guard inner(domain);
+        node* second = inner.protect(slots[(round + 1) % slot_count], 1);
+        check(readable(second), "node protected by a nested guard was freed");
+      }
+      // Give writers time to retire and scan while only the outer guard holds
+      for (int i = 0; i < 16; ++i) {
+        std::this_thread::yield();
+        check(readable(first), "node was freed after a nested guard left");
+      }
+      ++round;
+    }
+  }
+
+  void writer(JMK::reclamation_domain& domain, std::atomic<node*>* slots, const std::atomic<bool>& stop, size_t id) {
+    uint64_t round = id;
+    while (!stop.load(std::memory_order_relaxed)) {
+      node* old;
+      {
+        JMK::reclamation_domain::guard g(domain);
+        old = slots[round % slot_count].exchange(new node(round), std::memory_order_acq_rel);
+      }
+      domain.retire(old);
+      ++round;
+    }
+    domain.collect();
+  }
+
+  void run(JMK::reclamation_mode mode, const char* name, std::chrono::milliseconds duration) {
+    {
+      // A small threshold so scans, and with them frees, happen constantly
+      JMK::reclamation_domain domain(mode, 8);
+      std::atomic<node*> slots[slot_count];
+      for (auto& slot : slots) {
+        slot.store(new node(0), std::memory_order_relaxed);
+      }
+      std::atomic<bool> stop = false;
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < reader_count; ++i) {
+        threads.emplace_back(reader, std::ref(domain), slots, std::cref(stop), i);
+      }
+      for (size_t i = 0; i < writer_count; ++i) {
+        threads.emplace_back(writer, std::ref(domain), slots, std::cref(stop), i);
+      }
+      std::this_thread::sleep_for(duration);
+      stop.store(true, std::memory_order_relaxed);
+      for (auto& t : threads) {
+        t.join();
+      }
+      for (auto& slot : slots) {
+        delete slot.load(std::memory_order_relaxed);
+      }
+    }
+    check(s_live.load() == 0, "retired nodes outlived their domain");
+    std::printf("%s: %s\n", name, s_failures.load() == 0 ? "ok" : "FAILED");
+  }
+
+}
+
+int main(int argc, char** argv) {
+  double seconds = argc > 1 ? std::atof(argv[1]) : 1;
+  auto duration = std::chrono::milliseconds(static_cast<long>(seconds * 1000));
+  run(JMK::reclamation_mode::epoch, "epoch", duration);
+  run(JMK::reclamation_mode::hazard_pointers, "hazard_pointers", duration);
+  return s_failures.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+// Tests that JMK::unrolled_list keeps its nodes reasonably full when most of
+// its elements are erased, and that erase still returns the right iterator
+// while nodes merge and refill.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O1 -g -fsanitize=address,undefined -I.. unrolled_list.cpp -o unrolled_list
+//
+// and run ./unrolled_list. The exit status is 1 on failure.
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../unrolled_list.hpp"
+
+namespace {
+
+  size_t s_failures = 0;
+
+  void check(bool ok, const char* what) {
+    if (!ok) {
+      std::fprintf(stderr, "unrolled_list: %s\n", what);
+      ++s_failures;
+    }
+  }
+
+  // Every node but the last holds at least a quarter of its capacity, so
+  // there can be at most one node more than a quarter-full packing needs
+  template <typename _List>
+  [[nodiscard]] bool dense_enough(const _List& list) {
+    size_t quarter = _List::node_capacity / 4;
+    return list.node_count() <= (list.size() + quarter - 1) / quarter + 1;
+  }
+
+  template <typename _T, typename _Make>
+  void sparse_erase(const char* name, _Make make) {
+    JMK::unrolled_list<_T> list;
+    std::vector<_T> expected;
+    for (int i = 0; i < 20000; ++i) {
+      list.push_back(make(i));
+      if (i % 16 == 0) {
+        expected.push_back(make(i));
+      }
+    }
+
+    // Keep one element in sixteen, walking the list with erase's result
+    int i = 0;
+    for (auto it = list.begin(); it != list.end(); ++i) {
+      if (i % 16 == 0) {
+        ++it;
+      }
+      else {
+        it = list.erase(it);
+      }
+    }
+    check(list.size() == expected.size(), name);
+    check(std::equal(list.begin(), list.end(), expected.begin(), expected.end()), name);
+    check(dense_enough(list), name);
+
+    // And drain it from both ends and the middle
+    while (!list.empty()) {
+      list.erase(list.begin() + list.size() / 2);
+      if (!list.empty()) {
+        list.erase(list.begin());
+      }
+      check(dense_enough(list), name);
+    }
+    check(list.node_count() == 0, name);
+  }
+
+}
+
+int main() {
+  sparse_erase<int>("int", [](int i) { return i; });
+  sparse_erase<std::string>("std::string", [](int i) { return std::string(40, char('a' + i % 26)) + std::to_string(i); });
+  std::printf("unrolled_list: %s\n", s_failures == 0 ? "ok" : "FAILED");
+  return s_failures == 0 ? 0 : 1;
+}
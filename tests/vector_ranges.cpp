@@ -0,0 +1,120 @@
+// Tests range insertion into JMK::vector and JMK::small_vector from other
+// JMK containers, and that their iterators model the standard iterator
+// concepts so the containers are standard ranges.
+//
+// Build from this directory with
+//
+//   c++ -std=c++20 -O1 -g -fsanitize=address,undefined -I.. vector_ranges.cpp -o vector_ranges
+//
+// and run ./vector_ranges. Elements count how often they are moved, so a
+// range insert that falls back to appending and rotating shows up as well
+// as one that inserts the wrong elements. The exit status is 1 on failure.
+
+#include <cstdio>
+#include <iterator>
+#include <ranges>
+
+#include "../array.hpp"
+#include "../list.hpp"
+#include "../small_vector.hpp"
+#include "../vector.hpp"
+
+static_assert(std::contiguous_iterator<JMK::vector<int>::iterator>);
+static_assert(std::contiguous_iterator<JMK::vector<int>::const_iterator>);
+static_assert(std::contiguous_iterator<JMK::array<int, 4>::iterator>);
+static_assert(std::contiguous_iterator<JMK::array<int, 4>::const_iterator>);
+static_assert(std::bidirectional_iterator<JMK::list<int>::iterator>);
+static_assert(std::bidirectional_iterator<JMK::list<int>::const_iterator>);
+static_assert(std::ranges::contiguous_range<JMK::vector<int>>);
+static_assert(std::ranges::contiguous_range<const JMK::vector<int>>);
+static_assert(std::ranges::contiguous_range<JMK::small_vector<int, 4>>);
+static_assert(std::ranges::contiguous_range<JMK::array<int, 4>>);
+static_assert(std::ranges::bidirectional_range<JMK::list<int>>);
+
+namespace {
+
+  size_t s_failures = 0;
+  size_t s_moves = 0;
+
+  void check(bool ok, const char* what) {
+    if (!ok) {
+      std::fprintf(stderr, "vector_ranges: %s\n", what);
+      ++s_failures;
+    }
+  }
+
+  struct counted {
+    counted(int value = 0) noexcept : m_value(value) {}
+    counted(const counted&) = default;
+    counted(counted&& other) noexcept : m_value(other.m_value) { ++s_moves; }
+    counted& operator=(const counted&) = default;
+    counted& operator=(counted&& other) noexcept {
+      m_value = other.m_value;
+      ++s_moves;
+      return *this;
+    }
+
+    [[nodiscard]] bool operator==(const counted&) const = default;
+
+    int m_value;
+  };
+
+  template <typename _Container>
+  [[nodiscard]] bool holds(const _Container& c, std::initializer_list<int> expected) {
+    if (c.size() != expected.size()) {
+      return false;
+    }
+    auto it = c.begin();
+    for (int v : expected) {
+      if ((*it++).m_value != v) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <typename _Vector>
+  void insert_from_jmk(const char* name) {
+    JMK::vector<counted> source{ 1, 2, 3 };
+    JMK::list<counted> linked{ 4, 5 };
+    JMK::array<counted, 2> fixed{ 6, 7 };
+
+    _Vector v{ 10, 20 };
+    v.reserve(16);
+    s_moves = 0;
+    v.insert(v.begin() + 1, source.begin(), source.end());
+    check(holds(v, { 10, 1, 2, 3, 20 }), name);
+    // Only the one element after the gap moves; no append and rotate
+    check(s_moves == 1, name);
+
+    v.insert(v.end(), linked.begin(), linked.end());
+    v.insert(v.begin(), fixed.begin(), fixed.end());
+    check(holds(v, { 6, 7, 10, 1, 2, 3, 20, 4, 5 }), name);
+
+    v.append_range(source);
+    v.append_range(JMK::vector<counted>{ 8 });
+    v.append_range(linked);
+    check(holds(v, { 6, 7, 10, 1, 2, 3, 20, 4, 5, 1, 2, 3, 8, 4, 5 }), name);
+
+    v.insert(v.begin() + 2, 2, counted(0));
+    v.insert(v.end(), { 9, 9 });
+    check(holds(v, { 6, 7, 0, 0, 10, 1, 2, 3, 20, 4, 5, 1, 2, 3, 8, 4, 5, 9, 9 }), name);
+
+    // Growing out of the reserved or inline storage mid insert
+    _Vector small{ 1 };
+    JMK::vector<counted> many;
+    for (int i = 0; i < 40; ++i) {
+      many.push_back(i);
+    }
+    small.insert(small.begin(), many.begin(), many.end());
+    check(small.size() == 41 && small[0].m_value == 0 && small[39].m_value == 39 && small[40].m_value == 1, name);
+  }
+
+}
+
+int main() {
+  insert_from_jmk<JMK::vector<counted>>("vector");
+  insert_from_jmk<JMK::small_vector<counted, 4>>("small_vector");
+  std::printf("vector_ranges: %s\n", s_failures == 0 ? "ok" : "FAILED");
+  return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+namespace JMK {
+
+  // Assumed size of a cache line, used to keep independently written atomics
+  // from sharing one
+  inline constexpr size_t cache_line_size = 64;
+
+  // Marks types whose objects can be moved to a new address with a plain
+  // byte copy, leaving the source to be discarded without running its
+  // destructor. Trivially copyable types qualify automatically; specialize
+  // this for your own types to opt them in:
+  //
+  //   template <> struct JMK::is_trivially_relocatable<my_type> : std::true_type {};
+  template <typename _T>
+  struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<_T>> {};
+
+  template <typename _T>
+  inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<_T>::value;
+
+  // Marks types whose equality is exactly equality of their bytes, so runs of
+  // them can be compared with memcmp and hashed as raw memory. Defaults to
+  // integers, enums and pointers only: a class can have unique object
+  // representations and still define operator== on less than all of its
+  // bytes. Specialize this for your own types to opt them in:
+  //
+  //   template <> struct JMK::is_bitwise_comparable<my_type> : std::true_type {};
+  template <typename _T>
+  struct is_bitwise_comparable : std::bool_constant<std::is_integral_v<_T> || std::is_enum_v<_T> ||
+    std::is_pointer_v<_T>> {};
+
+  template <typename _T>
+  inline constexpr bool is_bitwise_comparable_v = is_bitwise_comparable<_T>::value;
+
+  // Allocators exposing reallocate(ptr, old_n, new_n) can grow a block in
+  // place, which containers use for trivially relocatable element types.
+  template <typename _Alloc>
+  concept reallocating_allocator = requires(_Alloc alloc, typename _Alloc::value_type* ptr, size_t n) {
+    { alloc.reallocate(ptr, n, n) } -> std::same_as<typename _Alloc::value_type*>;
+  };
+
+}
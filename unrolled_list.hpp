@@ -0,0 +1,513 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "traits.hpp"
+
+namespace JMK {
+
+  // Elements per node so that a node spans about four cache lines
+  template <typename _T>
+  inline constexpr size_t default_unroll =
+    std::max<size_t>(4, (4 * JMK::cache_line_size - 2 * sizeof(void*) - sizeof(uint32_t)) / sizeof(_T));
+
+  // JMK::list with nodes that each hold up to _N elements packed at the
+  // front of a small array. Scans walk contiguous memory and pay one link per
+  // _N elements instead of two per element. A full node is split in half on
+  // insert. A node that drains below a quarter on erase is merged with a
+  // neighbour if the two fit in one node, or else takes elements from its
+  // successor, so every node but the last stays at least a quarter full.
+  //
+  // Iterators are bidirectional as in JMK::list, but inserting or erasing
+  // invalidates iterators into the affected node and its neighbours, since
+  // elements shift within and between nodes.
+  template <typename _T, size_t _N = default_unroll<_T>>
+  class unrolled_list {
+    static_assert(_N >= 2, "JMK::unrolled_list needs at least two elements per node");
+
+    struct _link {
+      _link* m_next;
+      _link* m_prev;
+    };
+
+    struct _node : _link {
+      uint32_t m_count = 0;
+      alignas(_T) std::byte m_items[_N * sizeof(_T)];
+
+      [[nodiscard]] _T* item(size_t i) noexcept { return std::launder(reinterpret_cast<_T*>(m_items) + i); }
+    };
+
+  public:
+    template <typename _V>
+    class basic_iterator {
+      friend class JMK::unrolled_list<_T, _N>;
+
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = std::remove_cv_t<_V>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = _V*;
+      using reference = _V&;
+
+      basic_iterator() noexcept = default;
+      basic_iterator(_link* link, size_t index) noexcept : m_link(link), m_index(index) {}
+
+      template <typename _W> requires (std::is_const_v<_V> && !std::is_const_v<_W>)
+      basic_iterator(const basic_iterator<_W>& other) noexcept : m_link(other.m_link), m_index(other.m_index) {}
+
+      [[nodiscard]] reference operator*() const noexcept { return *static_cast<_node*>(m_link)->item(m_index); }
+      [[nodiscard]] pointer operator->() const noexcept { return &operator*(); }
+
+      basic_iterator& operator++() noexcept {
+        if (++m_index == static_cast<_node*>(m_link)->m_count) {
+          m_link = m_link->m_next;
+          m_index = 0;
+        }
+        return *this;
+      }
+
+      basic_iterator operator++(int) noexcept {
+        basic_iterator copy = *this;
+        ++*this;
+        return copy;
+      }
+
+      basic_iterator& operator--() noexcept {
+        if (m_index == 0) {
+          m_link = m_link->m_prev;
+          m_index = static_cast<_node*>(m_link)->m_count;
+        }
+        m_index -= 1;
+        return *this;
+      }
+
+      basic_iterator operator--(int) noexcept {
+        basic_iterator copy = *this;
+        --*this;
+        return copy;
+      }
+
+      // Skips whole nodes where it can
+      [[nodiscard]] basic_iterator operator+(difference_type i) const noexcept {
+        if (i < 0) {
+          return operator-(-i);
+        }
+        basic_iterator copy = *this;
+        size_t remaining = static_cast<size_t>(i);
+        while (remaining > 0) {
+          size_t left = static_cast<_node*>(copy.m_link)->m_count - copy.m_index;
+          if (remaining < left) {
+            copy.m_index += remaining;
+            break;
+          }
+          remaining -= left;
+          copy.m_link = copy.m_link->m_next;
+          copy.m_index = 0;
+        }
+        return copy;
+      }
+
+      [[nodiscard]] basic_iterator operator-(difference_type i) const noexcept {
+        if (i < 0) {
+          return operator+(-i);
+        }
+        basic_iterator copy = *this;
+        size_t remaining = static_cast<size_t>(i);
+        while (remaining > 0) {
+          if (remaining <= copy.m_index) {
+            copy.m_index -= remaining;
+            break;
+          }
+          remaining -= copy.m_index;
+          copy.m_link = copy.m_link->m_prev;
+          copy.m_index = static_cast<_node*>(copy.m_link)->m_count;
+        }
+        return copy;
+      }
+
+      [[nodiscard]] bool operator==(const basic_iterator& other) const noexcept {
+        return m_link == other.m_link && m_index == other.m_index;
+      }
+
+    private:
+      template <typename _W>
+      friend class basic_iterator;
+
+      _link* m_link = nullptr;
+      size_t m_index = 0;
+    };
+
+    using iterator = basic_iterator<_T>;
+    using const_iterator = basic_iterator<const _T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_t node_capacity = _N;
+
+    unrolled_list() noexcept {}
+
+    unrolled_list(const unrolled_list& other) {
+      _copy_from(other);
+    }
+
+    unrolled_list(unrolled_list&& other) noexcept {
+      _move_from(std::move(other));
+    }
+
+    unrolled_list(_T _fill, size_t size) {
+      resize(size);
+      fill(_fill);
+    }
+
+    unrolled_list(std::initializer_list<_T> list) {
+      for (const _T& item : list) {
+        emplace_back(item);
+      }
+    }
+
+    ~unrolled_list() {
+      clear();
+    }
+
+    unrolled_list& operator=(const unrolled_list& other) {
+      if (this != &other) {
+        clear();
+        _copy_from(other);
+      }
+      return *this;
+    }
+
+    unrolled_list& operator=(unrolled_list&& other) noexcept {
+      if (this != &other) {
+        clear();
+        _move_from(std::move(other));
+      }
+      return *this;
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+    [[nodiscard]] size_t max_size() const noexcept { return std::numeric_limits<size_t>::max(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] _T& at(size_t index) {
+      assert(index < size());
+      return *(begin() + index);
+    }
+
+    [[nodiscard]] const _T& at(size_t index) const {
+      assert(index < size());
+      return *(begin() + index);
+    }
+
+    [[nodiscard]] _T& operator[](size_t index) noexcept {
+      return *(begin() + index);
+    }
+
+    [[nodiscard]] const _T& operator[](size_t index) const noexcept {
+      return *(begin() + index);
+    }
+
+    [[nodiscard]] _T& front() noexcept { return *begin(); }
+    [[nodiscard]] const _T& front() const noexcept { return *begin(); }
+
+    [[nodiscard]] _T& back() noexcept { return *(end() - 1); }
+    [[nodiscard]] const _T& back() const noexcept { return *(end() - 1); }
+
+    void resize(size_t new_size) {
+      while (m_size > new_size) {
+        pop_back();
+      }
+      while (m_size < new_size) {
+        emplace_back();
+      }
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(m_sentinel.m_next, 0); }
+    [[nodiscard]] iterator end() noexcept { return iterator(&m_sentinel, 0); }
+    [[nodiscard]] const_iterator begin() const noexcept { return const_iterator(m_sentinel.m_next, 0); }
+    [[nodiscard]] const_iterator end() const noexcept { return const_iterator(_sentinel(), 0); }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    [[nodiscard]] reverse_const_iterator crbegin() const noexcept { return reverse_const_iterator(cend()); }
+    [[nodiscard]] reverse_const_iterator crend() const noexcept { return reverse_const_iterator(cbegin()); }
+
+    template <typename ... _Args>
+    void emplace_back(_Args&& ... args) {
+      emplace(end(), std::forward<_Args>(args)...);
+    }
+
+    void push_back(const _T& value) {
+      emplace(end(), value);
+    }
+
+    void push_back(_T&& value) {
+      emplace(end(), std::move(value));
+    }
+
+    _T pop_back() {
+      assert(m_size > 0);
+      _T value = std::move(back());
+      erase(end() - 1);
+      return value;
+    }
+
+    template <typename ... _Args>
+    iterator emplace(iterator pos, _Args&& ... args) {
+      // Build first so a throwing constructor leaves the list untouched
+      _T value(std::forward<_Args>(args)...);
+
+      _node* n;
+      size_t index;
+      if (pos.m_link == &m_sentinel) {
+        // Appending: fill the last node before starting a new one
+        if (m_sentinel.m_prev == &m_sentinel || _as_node(m_sentinel.m_prev)->m_count == _N) {
+          n = _create_node(m_sentinel.m_prev);
+        }
+        else {
+          n = _as_node(m_sentinel.m_prev);
+        }
+        index = n->m_count;
+      }
+      else {
+        n = _as_node(pos.m_link);
+        index = pos.m_index;
+        if (n->m_count == _N) {
+          _node* upper = _split(n);
+          if (index > n->m_count) {
+            index -= n->m_count;
+            n = upper;
+          }
+        }
+      }
+
+      _open_slot(n, index);
+      ::new(static_cast<void*>(n->item(index))) _T(std::move(value));
+      m_size += 1;
+      return iterator(n, index);
+    }
+
+    iterator insert(iterator pos, const _T& value) {
+      return emplace(pos, value);
+    }
+
+    iterator insert(iterator pos, _T&& value) {
+      return emplace(pos, std::move(value));
+    }
+
+    iterator erase(iterator pos) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      _node* n = _as_node(pos.m_link);
+      size_t index = pos.m_index;
+
+      n->item(index)->~_T();
+      _relocate(n->item(index), n->item(index + 1), n->m_count - index - 1);
+      n->m_count -= 1;
+      m_size -= 1;
+
+      if (n->m_count == 0) {
+        _link* next = n->m_next;
+        _destroy_node(n);
+        return iterator(next, 0);
+      }
+      if (n->m_count < _N / 4) {
+        n = _rebalance(n, index);
+      }
+      if (index == n->m_count) {
+        return iterator(n->m_next, 0);
+      }
+      return iterator(n, index);
+    }
+
+    iterator erase(iterator _beg, iterator _end) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      // Count first; erasing shifts elements and would move _end
+      size_t count = static_cast<size_t>(std::distance(_beg, _end));
+      while (count-- > 0) {
+        _beg = erase(_beg);
+      }
+      return _beg;
+    }
+
+    void clear() noexcept {
+      _link* link = m_sentinel.m_next;
+      while (link != &m_sentinel) {
+        _node* n = _as_node(link);
+        link = link->m_next;
+        for (size_t i = 0; i < n->m_count; ++i) {
+          n->item(i)->~_T();
+        }
+        _free_node(n);
+      }
+      m_sentinel.m_next = &m_sentinel;
+      m_sentinel.m_prev = &m_sentinel;
+      m_size = 0;
+    }
+
+    void fill(_T v) {
+      for (auto it = begin(); it != end(); ++it) {
+        *it = v;
+      }
+    }
+
+    void reset() {
+      fill(_T());
+    }
+
+    // Nodes currently allocated, for judging occupancy
+    [[nodiscard]] size_t node_count() const noexcept {
+      size_t count = 0;
+      for (const _link* link = m_sentinel.m_next; link != &m_sentinel; link = link->m_next) {
+        ++count;
+      }
+      return count;
+    }
+
+  private:
+    [[nodiscard]] static _node* _as_node(_link* link) noexcept { return static_cast<_node*>(link); }
+
+    [[nodiscard]] _link* _sentinel() const noexcept { return const_cast<_link*>(&m_sentinel); }
+
+    [[nodiscard]] static _node* _allocate_node() {
+      void* mem = ::operator new(sizeof(_node), std::align_val_t(alignof(_node)));
+      return ::new(mem) _node;
+    }
+
+    static void _free_node(_node* n) noexcept {
+      n->~_node();
+      ::operator delete(n, sizeof(_node), std::align_val_t(alignof(_node)));
+    }
+
+    // Links a fresh empty node after prev
+    _node* _create_node(_link* prev) {
+      _node* n = _allocate_node();
+      n->m_prev = prev;
+      n->m_next = prev->m_next;
+      prev->m_next->m_prev = n;
+      prev->m_next = n;
+      return n;
+    }
+
+    void _destroy_node(_node* n) noexcept {
+      n->m_prev->m_next = n->m_next;
+      n->m_next->m_prev = n->m_prev;
+      _free_node(n);
+    }
+
+    // Moves the upper half of a full node into a new node after it
+    _node* _split(_node* n) {
+      _node* upper = _create_node(n);
+      size_t keep = _N / 2;
+      _relocate(upper->item(0), n->item(keep), _N - keep);
+      upper->m_count = static_cast<uint32_t>(_N - keep);
+      n->m_count = static_cast<uint32_t>(keep);
+      return upper;
+    }
+
+    void _merge_next(_node* n) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      _node* next = _as_node(n->m_next);
+      _relocate(n->item(n->m_count), next->item(0), next->m_count);
+      n->m_count += next->m_count;
+      next->m_count = 0;
+      _destroy_node(next);
+    }
+
+    // Called when n drained below a quarter. Merges n into its predecessor or
+    // its successor into n if the two fit in one node; otherwise both
+    // neighbours are over three quarters full and n takes half the difference
+    // from its successor. The last node is left alone when nothing fits.
+    // Returns the node now holding the element that was at index in n and
+    // updates index to match.
+    _node* _rebalance(_node* n, size_t& index) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      _link* prev = n->m_prev;
+      _link* next = n->m_next;
+      if (prev != &m_sentinel && _as_node(prev)->m_count + n->m_count <= _N) {
+        _node* merged = _as_node(prev);
+        index += merged->m_count;
+        _merge_next(merged);
+        return merged;
+      }
+      if (next == &m_sentinel) {
+        return n;
+      }
+      _node* donor = _as_node(next);
+      if (n->m_count + donor->m_count <= _N) {
+        _merge_next(n);
+        return n;
+      }
+      size_t count = (donor->m_count - n->m_count) / 2;
+      _relocate(n->item(n->m_count), donor->item(0), count);
+      _relocate(donor->item(0), donor->item(count), donor->m_count - count);
+      n->m_count += static_cast<uint32_t>(count);
+      donor->m_count -= static_cast<uint32_t>(count);
+      return n;
+    }
+
+    // Shifts [index, count) up by one to free the slot at index
+    void _open_slot(_node* n, size_t index) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      if constexpr (JMK::is_trivially_relocatable_v<_T>) {
+        std::memmove(static_cast<void*>(n->item(index + 1)), n->item(index), (n->m_count - index) * sizeof(_T));
+      }
+      else {
+        for (size_t i = n->m_count; i > index; --i) {
+          ::new(static_cast<void*>(n->item(i))) _T(std::move(*n->item(i - 1)));
+          n->item(i - 1)->~_T();
+        }
+      }
+      n->m_count += 1;
+    }
+
+    // Moves count live objects from src to dst, leaving src dead. Ranges may
+    // overlap only with dst below src.
+    static void _relocate(_T* dst, _T* src, size_t count) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      if constexpr (JMK::is_trivially_relocatable_v<_T>) {
+        std::memmove(static_cast<void*>(dst), src, count * sizeof(_T));
+      }
+      else {
+        for (size_t i = 0; i < count; ++i) {
+          ::new(static_cast<void*>(dst + i)) _T(std::move(src[i]));
+          src[i].~_T();
+        }
+      }
+    }
+
+    void _copy_from(const unrolled_list& other) {
+      for (const _T& item : other) {
+        emplace_back(item);
+      }
+    }
+
+    void _move_from(unrolled_list&& other) noexcept {
+      if (other.empty()) {
+        return;
+      }
+      m_sentinel = other.m_sentinel;
+      m_size = other.m_size;
+      // The first and last nodes still link to the other list's sentinel
+      m_sentinel.m_next->m_prev = &m_sentinel;
+      m_sentinel.m_prev->m_next = &m_sentinel;
+      other.m_sentinel.m_next = &other.m_sentinel;
+      other.m_sentinel.m_prev = &other.m_sentinel;
+      other.m_size = 0;
+    }
+
+    _link m_sentinel { &m_sentinel, &m_sentinel };
+    size_t m_size = 0;
+  };
+
+}
@@ -2,13 +2,26 @@
 
 #include <cassert>
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+
+#include "compare.hpp"
+#include "hash.hpp"
+#include "instrument.hpp"
+#include "simd.hpp"
+#include "traits.hpp"
 
 namespace JMK {
 
-  template <typename _T>
+  template <typename _T, typename _Alloc = std::allocator<_T>>
   class vector {
   public:
     class iterator {
@@ -19,7 +32,7 @@ namespace JMK {
       using pointer = value_type*;
       using reference = value_type&;
 
-      constexpr iterator() = delete;
+      constexpr iterator() noexcept = default;
       constexpr iterator(const iterator&) noexcept = default;
       constexpr iterator(iterator&&) noexcept = default;
       constexpr iterator(pointer value) noexcept : m_value(value) {}
@@ -27,7 +40,25 @@ namespace JMK {
       [[nodiscard]] constexpr iterator operator+(difference_type i) const noexcept {
         iterator copy = *this;
         copy.m_value += i;
-        return *copy;
+        return copy;
+      }
+
+      [[nodiscard]] friend constexpr iterator operator+(difference_type i, const iterator& it) noexcept {
+        return it + i;
+      }
+
+      constexpr iterator& operator+=(difference_type i) noexcept {
+        m_value += i;
+        return *this;
+      }
+
+      constexpr iterator& operator-=(difference_type i) noexcept {
+        m_value -= i;
+        return *this;
+      }
+
+      [[nodiscard]] constexpr reference operator[](difference_type i) const noexcept {
+        return m_value[i];
       }
 
       constexpr iterator& operator++() noexcept {
@@ -35,7 +66,7 @@ namespace JMK {
         return *this;
       }
 
-      constexpr iterator& operator++(int) noexcept {
+      constexpr iterator operator++(int) noexcept {
         iterator copy = *this;
         ++m_value;
         return copy;
@@ -44,7 +75,7 @@ namespace JMK {
       [[nodiscard]] constexpr iterator operator-(difference_type i) const noexcept {
         iterator copy = *this;
         copy.m_value -= i;
-        return *copy;
+        return copy;
       }
 
       [[nodiscard]] constexpr difference_type operator-(const iterator& other) const noexcept {
@@ -56,17 +87,17 @@ namespace JMK {
         return *this;
       }
 
-      constexpr iterator& operator--(int) noexcept {
+      constexpr iterator operator--(int) noexcept {
         iterator copy = *this;
         --m_value;
         return copy;
       }
 
-      [[nodiscard]] constexpr reference operator*() noexcept {
+      [[nodiscard]] constexpr reference operator*() const noexcept {
         return *m_value;
       }
 
-      [[nodiscard]] constexpr pointer operator->() noexcept {
+      [[nodiscard]] constexpr pointer operator->() const noexcept {
         return m_value;
       }
 
@@ -76,21 +107,22 @@ namespace JMK {
       [[nodiscard]] constexpr std::strong_ordering operator<=>(const iterator& other) const& = default;
 
     private:
-      pointer m_value;
+      pointer m_value = nullptr;
     };
 
     class const_iterator {
     public:
       using iterator_category = std::contiguous_iterator_tag;
-      using value_type = std::remove_reference_t<const _T>;
+      using value_type = std::remove_reference_t<_T>;
       using difference_type = std::ptrdiff_t;
-      using pointer = value_type*;
-      using reference = value_type&;
+      using pointer = const value_type*;
+      using reference = const value_type&;
 
-      constexpr const_iterator() = delete;
+      constexpr const_iterator() noexcept = default;
       constexpr const_iterator(const const_iterator&) noexcept = default;
       constexpr const_iterator(const_iterator&&) noexcept = default;
       constexpr const_iterator(pointer value) noexcept : m_value(value) {}
+      constexpr const_iterator(const iterator& other) noexcept : m_value(other.operator->()) {}
 
       [[nodiscard]] constexpr const_iterator operator+(difference_type i) const noexcept {
         const_iterator copy = *this;
@@ -98,12 +130,30 @@ namespace JMK {
         return copy;
       }
 
+      [[nodiscard]] friend constexpr const_iterator operator+(difference_type i, const const_iterator& it) noexcept {
+        return it + i;
+      }
+
+      constexpr const_iterator& operator+=(difference_type i) noexcept {
+        m_value += i;
+        return *this;
+      }
+
+      constexpr const_iterator& operator-=(difference_type i) noexcept {
+        m_value -= i;
+        return *this;
+      }
+
+      [[nodiscard]] constexpr reference operator[](difference_type i) const noexcept {
+        return m_value[i];
+      }
+
       constexpr const_iterator& operator++() noexcept {
         ++m_value;
         return *this;
       }
 
-      constexpr const_iterator& operator++(int) noexcept {
+      constexpr const_iterator operator++(int) noexcept {
         const_iterator copy = *this;
         ++m_value;
         return copy;
@@ -124,17 +174,17 @@ namespace JMK {
         return *this;
       }
 
-      constexpr const_iterator& operator--(int) noexcept {
+      constexpr const_iterator operator--(int) noexcept {
         const_iterator copy = *this;
         --m_value;
         return copy;
       }
 
-      [[nodiscard]] constexpr reference operator*() noexcept {
+      [[nodiscard]] constexpr reference operator*() const noexcept {
         return *m_value;
       }
 
-      [[nodiscard]] constexpr pointer operator->() noexcept {
+      [[nodiscard]] constexpr pointer operator->() const noexcept {
         return m_value;
       }
 
@@ -144,50 +194,127 @@ namespace JMK {
       [[nodiscard]] constexpr std::strong_ordering operator<=>(const const_iterator& other) const& = default;
 
     private:
-      pointer m_value;
+      pointer m_value = nullptr;
     };
 
     using reverse_iterator = std::reverse_iterator<iterator>;
     using reverse_const_iterator = std::reverse_iterator<const_iterator>;
 
-    constexpr vector() noexcept(std::is_trivially_constructible_v<_T>) : vector(_T(), 0) {}
+    using allocator_type = _Alloc;
+
+    constexpr vector() noexcept(std::is_nothrow_default_constructible_v<_Alloc>) : m_alloc() {}
+
+    constexpr explicit vector(const _Alloc& alloc) noexcept : m_alloc(alloc) {}
+
+    constexpr vector(const vector& other) : m_growth_factor(other.m_growth_factor),
+      m_alloc(_alloc_traits::select_on_container_copy_construction(other.m_alloc)) {
+      _copy_from(other.m_data, other.m_size);
+    }
+
+    constexpr vector(vector&& other) noexcept : m_data(other.m_data), m_size(other.m_size),
+      m_capacity(other.m_capacity), m_growth_factor(other.m_growth_factor), m_alloc(std::move(other.m_alloc)),
+      m_probe(std::move(other.m_probe)) {
+      other.m_data = nullptr;
+      other.m_size = 0;
+      other.m_capacity = 0;
+    }
 
-    template <typename _U>
-    constexpr vector(const vector<_U>& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    template <typename _U, typename _UAlloc>
+    constexpr vector(const vector<_U, _UAlloc>& other, const _Alloc& alloc = _Alloc()) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_copy_assignable_v<_U>&&
-      std::is_trivially_constructible_v<_U>) : m_growth_factor(1.5f) {
-      resize(other.size());
+      std::is_trivially_constructible_v<_U>) : m_alloc(alloc) {
+      _reserve_impl(other.size());
       for (size_t i = 0; i < other.size(); ++i) {
-        m_data[i] = other.m_data[i];
+        _construct_at(&m_data[i], other[i]);
       }
+      m_size = other.size();
     }
 
-    template <typename _U>
-    constexpr vector(vector<_U>&& other) noexcept(std::is_trivially_assignable_v<_T>&&
+    template <typename _U, typename _UAlloc>
+    constexpr vector(vector<_U, _UAlloc>&& other, const _Alloc& alloc = _Alloc()) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>&&
       std::is_trivially_move_assignable_v<_U>&&
-      std::is_trivially_constructible_v<_U>) : m_growth_factor(1.5f) {
-      resize(other.size());
+      std::is_trivially_constructible_v<_U>) : m_alloc(alloc) {
+      _reserve_impl(other.size());
       for (size_t i = 0; i < other.size(); ++i) {
-        m_data[i] = std::move(other.m_data[i]);
+        _construct_at(&m_data[i], std::move(other[i]));
       }
+      m_size = other.size();
     }
 
-    constexpr vector(_T _fill, size_t size) noexcept(std::is_trivially_copy_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) : m_growth_factor(1.5f) {
+    constexpr vector(_T _fill, size_t size, const _Alloc& alloc = _Alloc()) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) : m_alloc(alloc) {
       resize(size);
       fill(_fill);
     }
 
-    constexpr vector(std::initializer_list<_T> list) noexcept(std::is_trivially_copy_assignable_v<_T>&&
-      std::is_trivially_constructible_v<_T>) : m_growth_factor(1.5f) {
-      resize(list.size());
-      for (size_t i = 0; i < list.size(); ++i) {
-        m_data[i] = *(list.begin() + i);
+    constexpr vector(std::initializer_list<_T> list, const _Alloc& alloc = _Alloc()) noexcept(std::is_trivially_copy_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) : m_alloc(alloc) {
+      _copy_from(list.begin(), list.size());
+    }
+
+    constexpr ~vector() {
+      _destroy_range(0, m_size);
+      _deallocate_storage();
+    }
+
+    constexpr vector& operator=(const vector& other) {
+      if (this == &other) {
+        return *this;
+      }
+      _destroy_range(0, m_size);
+      m_size = 0;
+      if constexpr (_alloc_traits::propagate_on_container_copy_assignment::value) {
+        if (m_alloc != other.m_alloc) {
+          _deallocate_storage();
+        }
+        m_alloc = other.m_alloc;
+      }
+      _copy_from(other.m_data, other.m_size);
+      return *this;
+    }
+
+    constexpr vector& operator=(vector&& other) noexcept(_alloc_traits::propagate_on_container_move_assignment::value ||
+      _alloc_traits::is_always_equal::value) {
+      if (this == &other) {
+        return *this;
       }
+      _destroy_range(0, m_size);
+      m_size = 0;
+      if constexpr (!_alloc_traits::propagate_on_container_move_assignment::value &&
+        !_alloc_traits::is_always_equal::value) {
+        // Storage owned by a foreign allocator cannot be adopted, move element-wise
+        if (m_alloc != other.m_alloc) {
+          _reserve_impl(other.m_size);
+          for (size_t i = 0; i < other.m_size; ++i) {
+            _construct_at(&m_data[i], std::move(other.m_data[i]));
+          }
+          m_size = other.m_size;
+          return *this;
+        }
+      }
+      _deallocate_storage();
+      if constexpr (_alloc_traits::propagate_on_container_move_assignment::value) {
+        m_alloc = std::move(other.m_alloc);
+      }
+      m_data = other.m_data;
+      m_size = other.m_size;
+      m_capacity = other.m_capacity;
+      m_growth_factor = other.m_growth_factor;
+      m_probe = std::move(other.m_probe);
+      other.m_data = nullptr;
+      other.m_size = 0;
+      other.m_capacity = 0;
+      return *this;
     }
 
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept { return m_alloc; }
+
+    // Allocation and growth counts of this vector; all zero unless built
+    // with JMK_INSTRUMENT
+    [[nodiscard]] constexpr JMK::instrument::counters instrumentation() const noexcept { return m_probe.get(); }
+
     [[nodiscard]] constexpr size_t size() const noexcept { return m_size; }
     [[nodiscard]] constexpr size_t max_size() const noexcept { return std::numeric_limits<size_t>::max(); }
     [[nodiscard]] constexpr size_t capacity() const noexcept { return m_capacity; }
@@ -225,6 +352,40 @@ namespace JMK {
       _resize_impl(new_size);
     }
 
+    // Grows without value-initializing the new slots. Elements are
+    // default-initialized, so trivial types are left indeterminate.
+    void resize_default_init(size_t new_size) {
+      _resize_default_init_impl(new_size);
+    }
+
+    // Grows without touching the new slots at all, for trivial types that are
+    // about to be overwritten by a bulk read or a decode loop
+    void resize_uninitialized(size_t new_size) {
+      static_assert(std::is_trivially_default_constructible_v<_T> && std::is_trivially_destructible_v<_T>,
+        "JMK::vector::resize_uninitialized requires a trivial element type");
+      _resize_default_init_impl(new_size);
+    }
+
+    // Grows by count default-initialized elements and hands the new region to
+    // callback as a std::span<_T>. If the callback returns a count, the vector
+    // is trimmed to keep only that many of the appended elements.
+    template <typename _Fn>
+    size_t append_with(size_t count, _Fn&& callback) {
+      size_t offset = m_size;
+      _resize_default_init_impl(m_size + count);
+      std::span<_T> region(m_data + offset, count);
+      if constexpr (std::is_void_v<std::invoke_result_t<_Fn, std::span<_T>>>) {
+        std::invoke(std::forward<_Fn>(callback), region);
+        return count;
+      }
+      else {
+        size_t written = std::min<size_t>(std::invoke(std::forward<_Fn>(callback), region), count);
+        _destroy_range(offset + written, m_size);
+        m_size = offset + written;
+        return written;
+      }
+    }
+
     void reserve(size_t new_capacity) {
       _reserve_impl(new_capacity);
     }
@@ -237,101 +398,134 @@ namespace JMK {
       m_growth_factor = std::max(factor, 1.1f);
     }
 
-    [[nodiscard]] constexpr iterator begin() noexcept { return &m_data[0]; }
-    [[nodiscard]] constexpr iterator end() noexcept { return &m_data[size()]; }
-    [[nodiscard]] constexpr const_iterator begin() const noexcept { return &m_data[0]; }
-    [[nodiscard]] constexpr const_iterator end() const noexcept { return &m_data[size()]; }
+    [[nodiscard]] constexpr iterator begin() noexcept { return m_data; }
+    [[nodiscard]] constexpr iterator end() noexcept { return m_data + m_size; }
+    [[nodiscard]] constexpr const_iterator begin() const noexcept { return m_data; }
+    [[nodiscard]] constexpr const_iterator end() const noexcept { return m_data + m_size; }
 
-    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return &m_data[0]; }
-    [[nodiscard]] constexpr const_iterator cend() const noexcept { return &m_data[size()]; }
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return m_data; }
+    [[nodiscard]] constexpr const_iterator cend() const noexcept { return m_data + m_size; }
 
-    [[nodiscard]] constexpr reverse_iterator rbegin() noexcept { return &m_data[size()]; }
-    [[nodiscard]] constexpr reverse_iterator rend() noexcept { return &m_data[0]; }
+    [[nodiscard]] constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
 
-    [[nodiscard]] constexpr reverse_iterator crbegin() const noexcept { return &m_data[size()]; }
-    [[nodiscard]] constexpr reverse_iterator crend() const noexcept { return &m_data[0]; }
+    [[nodiscard]] constexpr reverse_const_iterator crbegin() const noexcept { return reverse_const_iterator(cend()); }
+    [[nodiscard]] constexpr reverse_const_iterator crend() const noexcept { return reverse_const_iterator(cbegin()); }
 
     template <typename ... _Args>
     constexpr void emplace_back(_Args&& ... args) noexcept(std::is_trivially_constructible_v<_T>) {
       if (m_size >= m_capacity) {
+        // Built before growing in case the arguments alias an element
+        _T value(std::forward<_Args>(args)...);
         _reserve_impl(static_cast<size_t>(m_capacity * m_growth_factor));
+        _construct_at(&m_data[m_size], std::move(value));
+      }
+      else {
+        _construct_at(&m_data[m_size], std::forward<_Args>(args)...);
       }
-      _construct_at(&m_data[m_size], std::forward<_Args>(args)...);
       m_size += 1;
     }
 
     constexpr void push_back(const _T& value) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) {
       if (m_size >= m_capacity) {
+        _T copy(value);
         _reserve_impl(static_cast<size_t>(m_capacity * m_growth_factor));
+        _construct_at(&m_data[m_size], std::move(copy));
+      }
+      else {
+        _construct_at(&m_data[m_size], value);
+      }
+      m_size += 1;
+    }
+
+    constexpr void push_back(_T&& value) noexcept(std::is_trivially_move_assignable_v<_T>&&
+      std::is_trivially_constructible_v<_T>) {
+      if (m_size >= m_capacity) {
+        _T copy(std::move(value));
+        _reserve_impl(static_cast<size_t>(m_capacity * m_growth_factor));
+        _construct_at(&m_data[m_size], std::move(copy));
+      }
+      else {
+        _construct_at(&m_data[m_size], std::move(value));
       }
-      _construct_at(&m_data[m_size], value);
       m_size += 1;
     }
 
     constexpr _T pop_back() noexcept(std::is_trivially_copy_assignable_v<_T>&& std::is_trivially_constructible_v<_T>) {
       assert(m_size > 0);
-      return m_data[--m_size];
+      _T value = std::move(m_data[--m_size]);
+      _destroy_at(&m_data[m_size]);
+      return value;
     }
 
     template <typename ... _Args>
     constexpr iterator emplace(const_iterator pos, _Args&& ... args) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_constructible_v<_T>) {
-      if (m_size == m_capacity) {
-        _reserve_impl(static_cast<size_t>(m_capacity * m_growth_factor));
-      }
-      // Shift all future elements right
-      for (auto it = end(); it != pos; --it) {
-        *it = *(it - 1);
-      }
-      // Insert
-      _construct_at(std::addressof(*pos), std::forward<_Args>(args)...);
-      ++m_size;
-      return pos;
+      size_t index = static_cast<size_t>(pos - cbegin());
+      // Built up front in case the arguments alias an element that moves
+      _T value(std::forward<_Args>(args)...);
+      if (index == m_size) {
+        emplace_back(std::move(value));
+        return m_data + index;
+      }
+      _T* gap = _open_gap(index, 1);
+      _construct_at(gap, std::move(value));
+      return gap;
     }
 
     constexpr iterator insert(const_iterator pos, const _T& value) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) {
-      if (m_size == m_capacity) {
-        _reserve_impl(static_cast<size_t>(m_capacity * m_growth_factor));
+      return emplace(pos, value);
+    }
+
+    constexpr iterator insert(const_iterator pos, size_t count, const _T& value) {
+      size_t index = static_cast<size_t>(pos - cbegin());
+      if (count == 0) {
+        return m_data + index;
       }
-      // Shift all future elements right
-      for (auto it = end(); it != pos; --it) {
-        *it = *(it - 1);
+      _T copy(value);
+      _T* gap = _open_gap(index, count);
+      for (size_t i = 0; i < count; ++i) {
+        _construct_at(&gap[i], copy);
       }
-      // Insert
-      _construct_at(std::addressof(*pos), value);
-      ++m_size;
-      return pos;
+      return gap;
+    }
+
+    template <std::input_iterator _It>
+    constexpr iterator insert(const_iterator pos, _It first, _It last) {
+      return _insert_range(static_cast<size_t>(pos - cbegin()), std::move(first), std::move(last));
+    }
+
+    constexpr iterator insert(const_iterator pos, std::initializer_list<_T> list) {
+      return _insert_range(static_cast<size_t>(pos - cbegin()), list.begin(), list.end());
+    }
+
+    template <std::ranges::input_range _Range>
+    constexpr void append_range(_Range&& range) {
+      _insert_range(m_size, std::ranges::begin(range), std::ranges::end(range));
     }
 
     constexpr iterator erase(iterator pos) noexcept(std::is_trivially_destructible_v<_T>) {
-      if constexpr (std::is_pointer_v<_T>) {
-        delete (*pos);
-      }
-      else if (std::is_destructible_v<_T>) {
-        (*pos).~_T();
-      }
-      for (auto it = pos + 1; it != end(); ++it) {
-        *(it - 1) = *it;
-      }
-      --m_size;
-      return pos;
+      return erase(pos, pos + 1);
     }
 
     constexpr iterator erase(iterator _beg, iterator _end) noexcept(std::is_trivially_destructible_v<_T>) {
-      for (auto it = _beg + 1; it != _end; ++it) {
-        if constexpr (std::is_pointer_v<_T>) {
-          delete (*it);
-        }
-        else if (std::is_destructible_v<_T>) {
-          (*it).~_T();
+      size_t first = static_cast<size_t>(_beg - begin());
+      size_t last = static_cast<size_t>(_end - begin());
+      if (first == last) {
+        return _beg;
+      }
+      if constexpr (std::is_pointer_v<_T>) {
+        for (size_t i = first; i < last; ++i) {
+          delete m_data[i];
         }
       }
-      for (auto it = _end; it != end(); ++it) {
-        *(it - (_end - _beg)) = *it;
+      for (size_t i = last; i < m_size; ++i) {
+        m_data[i - (last - first)] = std::move(m_data[i]);
       }
-      --m_size;
+      _destroy_range(m_size - (last - first), m_size);
+      m_size -= last - first;
       return _beg;
     }
 
@@ -341,6 +535,12 @@ namespace JMK {
 
     constexpr void fill(_T v) noexcept(std::is_trivially_copy_assignable_v<_T>&&
       std::is_trivially_constructible_v<_T>) {
+      if constexpr (JMK::simd::arithmetic<_T>) {
+        if (!std::is_constant_evaluated()) {
+          JMK::simd::fill(m_data, size(), v);
+          return;
+        }
+      }
       for (size_t i = 0; i < size(); ++i) {
         m_data[i] = v;
       }
@@ -351,6 +551,14 @@ namespace JMK {
       fill(_T());
     }
 
+    [[nodiscard]] constexpr bool operator==(const vector& other) const requires std::equality_comparable<_T> {
+      return JMK::equal_ranges(data(), size(), other.data(), other.size());
+    }
+
+    [[nodiscard]] constexpr auto operator<=>(const vector& other) const requires std::three_way_comparable<_T> {
+      return JMK::compare_ranges(data(), size(), other.data(), other.size());
+    }
+
     [[nodiscard]] explicit operator std::string() const noexcept {
       std::string out;
       for (size_t i = 0; i < size(); ++i) {
@@ -363,28 +571,100 @@ namespace JMK {
     }
 
     // Friend declaration for the stream operator
-    template <typename _Ty>
-    friend std::ostream& operator<<(std::ostream& os, const vector<_Ty>& obj);
+    template <typename _Ty, typename _TyAlloc>
+    friend std::ostream& operator<<(std::ostream& os, const vector<_Ty, _TyAlloc>& obj);
 
   protected:
     constexpr void _strict_resize_impl(size_t new_size) noexcept(std::is_trivially_copy_assignable_v<_T>&& std::is_trivially_constructible_v<_T>) {
       _reserve_impl(new_size);
       for (size_t i = m_size; i < new_size; ++i) {
-        m_data[i] = _T();
+        _construct_at(&m_data[i]);
       }
+      _destroy_range(new_size, m_size);
       m_size = new_size;
     }
 
     constexpr void _resize_impl(size_t new_size) noexcept(std::is_trivially_copy_assignable_v<_T>&& std::is_trivially_constructible_v<_T>) {
+      _grow_to(new_size);
+      for (size_t i = m_size; i < new_size; ++i) {
+        _construct_at(&m_data[i]);
+      }
+      _destroy_range(new_size, m_size);
+      m_size = new_size;
+    }
+
+    constexpr void _resize_default_init_impl(size_t new_size) noexcept(std::is_nothrow_default_constructible_v<_T>) {
+      _grow_to(new_size);
+      if constexpr (!std::is_trivially_default_constructible_v<_T>) {
+        for (size_t i = m_size; i < new_size; ++i) {
+          ::new(static_cast<void*>(&m_data[i])) _T;
+        }
+      }
+      _destroy_range(new_size, m_size);
+      m_size = new_size;
+    }
+
+    constexpr void _grow_to(size_t new_size) {
+      if (new_size <= m_capacity) {
+        return;
+      }
+      _reserve_impl(_grown_capacity(new_size));
+    }
+
+    [[nodiscard]] constexpr size_t _grown_capacity(size_t new_size) const noexcept {
       size_t new_capacity = std::max<size_t>(m_capacity, 4);
       while (new_capacity < new_size) {
         new_capacity = static_cast<size_t>(new_capacity * m_growth_factor);
       }
-      _reserve_impl(new_capacity);
-      for (size_t i = m_size; i < new_size; ++i) {
-        m_data[i] = _T();
+      return new_capacity;
+    }
+
+    // Opens count raw slots at index and returns them. The tail is relocated
+    // exactly once, straight into the new block when the vector has to grow.
+    constexpr _T* _open_gap(size_t index, size_t count) {
+      if (m_size + count > m_capacity) {
+        size_t new_capacity = _grown_capacity(m_size + count);
+        if constexpr (!(JMK::is_trivially_relocatable_v<_T> && JMK::reallocating_allocator<_Alloc>)) {
+          _T* new_data = _alloc_traits::allocate(m_alloc, new_capacity);
+          m_probe.on_allocate(new_capacity * sizeof(_T));
+          m_probe.on_grow(m_capacity, new_capacity, m_size * sizeof(_T));
+          _relocate(new_data, m_data, index);
+          _relocate(new_data + index + count, m_data + index, m_size - index);
+          _deallocate_storage();
+          m_data = new_data;
+          m_capacity = new_capacity;
+          m_size += count;
+          return m_data + index;
+        }
+        _reserve_impl(new_capacity);
+      }
+      _relocate_backward(m_data + index + count, m_data + index, m_size - index);
+      m_size += count;
+      return m_data + index;
+    }
+
+    template <typename _It, typename _Sent>
+    constexpr iterator _insert_range(size_t index, _It first, _Sent last) {
+      if constexpr (std::forward_iterator<_It>) {
+        size_t count = static_cast<size_t>(std::ranges::distance(first, last));
+        if (count == 0) {
+          return m_data + index;
+        }
+        _T* gap = _open_gap(index, count);
+        for (size_t i = 0; i < count; ++i, ++first) {
+          _construct_at(&gap[i], *first);
+        }
+        return gap;
+      }
+      else {
+        // Single pass input, so the length is unknown until it is consumed
+        size_t old_size = m_size;
+        for (; first != last; ++first) {
+          emplace_back(*first);
+        }
+        std::rotate(m_data + index, m_data + old_size, m_data + m_size);
+        return m_data + index;
       }
-      m_size = new_size;
     }
 
     constexpr void _reserve_impl(size_t new_capacity) {
@@ -393,33 +673,116 @@ namespace JMK {
         return;
       }
 
-      _T* new_data = new _T[new_capacity];
-      for (size_t i = 0; i < m_size; ++i) {
-        new_data[i] = m_data[i];
+      if constexpr (JMK::is_trivially_relocatable_v<_T> && JMK::reallocating_allocator<_Alloc>) {
+        // Counted as a fresh block and a full copy, whether or not the
+        // allocator managed to extend in place
+        if (m_data) {
+          m_probe.on_deallocate(m_capacity * sizeof(_T));
+        }
+        m_probe.on_allocate(new_capacity * sizeof(_T));
+        m_probe.on_grow(m_capacity, new_capacity, m_size * sizeof(_T));
+        m_data = m_alloc.reallocate(m_data, m_capacity, new_capacity);
+        m_capacity = new_capacity;
+        return;
       }
-      delete[] m_data;
+
+      // Only the live elements are relocated, the rest of the block stays raw
+      _T* new_data = _alloc_traits::allocate(m_alloc, new_capacity);
+      m_probe.on_allocate(new_capacity * sizeof(_T));
+      m_probe.on_grow(m_capacity, new_capacity, m_size * sizeof(_T));
+      _relocate(new_data, m_data, m_size);
+      _deallocate_storage();
       m_data = new_data;
       m_capacity = new_capacity;
     }
 
+    // Moves count elements from src into the raw storage at dst and ends the
+    // lifetime of the sources
+    constexpr void _relocate(_T* dst, _T* src, size_t count) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      if (count == 0) {
+        return;
+      }
+      if constexpr (JMK::is_trivially_relocatable_v<_T>) {
+        if (!std::is_constant_evaluated()) {
+          std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(_T));
+          return;
+        }
+      }
+      for (size_t i = 0; i < count; ++i) {
+        _construct_at(&dst[i], std::move_if_noexcept(src[i]));
+        _destroy_at(&src[i]);
+      }
+    }
+
     template <typename ... _Args>
-    constexpr void _construct_at(void* ptr, _Args&&... value) noexcept(std::is_trivially_constructible_v<_T>) {
-      new(ptr) _T(std::forward<_Args>(value)...);
+    constexpr void _construct_at(_T* ptr, _Args&&... value) noexcept(std::is_trivially_constructible_v<_T>) {
+      _alloc_traits::construct(m_alloc, ptr, std::forward<_Args>(value)...);
+    }
+
+    constexpr void _destroy_at(_T* ptr) noexcept {
+      _alloc_traits::destroy(m_alloc, ptr);
+    }
+
+    constexpr void _destroy_range(size_t first, size_t last) noexcept {
+      if constexpr (!std::is_trivially_destructible_v<_T>) {
+        for (size_t i = first; i < last; ++i) {
+          _destroy_at(&m_data[i]);
+        }
+      }
+    }
+
+    constexpr void _deallocate_storage() noexcept {
+      if (m_data) {
+        m_probe.on_deallocate(m_capacity * sizeof(_T));
+        _alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+      }
+      m_data = nullptr;
+      m_capacity = 0;
+    }
+
+    // Relocates to a higher, possibly overlapping address, back to front
+    constexpr void _relocate_backward(_T* dst, _T* src, size_t count) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+      if (count == 0) {
+        return;
+      }
+      if constexpr (JMK::is_trivially_relocatable_v<_T>) {
+        if (!std::is_constant_evaluated()) {
+          std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(_T));
+          return;
+        }
+      }
+      for (size_t i = count; i > 0; --i) {
+        _construct_at(&dst[i - 1], std::move_if_noexcept(src[i - 1]));
+        _destroy_at(&src[i - 1]);
+      }
+    }
+
+    template <typename _Ptr>
+    constexpr void _copy_from(_Ptr src, size_t count) {
+      _reserve_impl(count);
+      for (size_t i = 0; i < count; ++i) {
+        _construct_at(&m_data[i], src[i]);
+      }
+      m_size = count;
     }
 
   private:
-    _T* m_data;
-    size_t m_size;
-    size_t m_capacity;
-    float m_growth_factor;
+    using _alloc_traits = std::allocator_traits<_Alloc>;
+
+    _T* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_capacity = 0;
+    float m_growth_factor = 1.5f;
+    [[no_unique_address]] _Alloc m_alloc;
+    [[no_unique_address]] JMK::instrument::probe<vector> m_probe;
   };
 
 }
 
 namespace JMK {
 
-  template <typename _T>
-  inline std::ostream& operator<<(std::ostream& os, const JMK::vector<_T>& arr) {
+  template <typename _T, typename _Alloc>
+  inline std::ostream& operator<<(std::ostream& os, const JMK::vector<_T, _Alloc>& arr) {
     os << "[";
     for (size_t i = 0; i < arr.size(); ++i) {
       os << arr[i];
@@ -431,4 +794,12 @@ namespace JMK {
     return os;
   }
 
-}
\ No newline at end of file
+}
+
+template <typename _T, typename _Alloc>
+  requires JMK::range_hashable<_T>
+struct std::hash<JMK::vector<_T, _Alloc>> {
+  [[nodiscard]] size_t operator()(const JMK::vector<_T, _Alloc>& value) const noexcept {
+    return JMK::hash_range(value.data(), value.size());
+  }
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#include "traits.hpp"
+#include "vector.hpp"
+
+namespace JMK {
+
+  // Chase-Lev work-stealing deque. The owning thread pushes and pops at the
+  // bottom like stack<_T, 0>::push/pop, while any number of thieves steal
+  // from the top. Elements are read and written through std::atomic_ref, so
+  // they must be trivially copyable (task pointers, indices, handles).
+  template <typename _T>
+  class work_stealing_deque {
+    static_assert(std::is_trivially_copyable_v<_T>, "JMK::work_stealing_deque requires a trivially copyable type");
+
+    // Circular buffer over a JMK::vector. Buffers are never shrunk and a grown
+    // one keeps a link to its predecessor, since thieves may still be reading
+    // it, until the deque itself is destroyed.
+    struct _ring {
+      explicit _ring(size_t capacity, _ring* prev) : m_mask(capacity - 1), m_prev(prev) {
+        m_data.resize_default_init(capacity);
+      }
+
+      [[nodiscard]] size_t capacity() const noexcept { return m_mask + 1; }
+
+      [[nodiscard]] _T load(int64_t index) noexcept {
+        return std::atomic_ref<_T>(m_data[static_cast<size_t>(index) & m_mask]).load(std::memory_order_relaxed);
+      }
+
+      void store(int64_t index, _T value) noexcept {
+        std::atomic_ref<_T>(m_data[static_cast<size_t>(index) & m_mask]).store(value, std::memory_order_relaxed);
+      }
+
+      JMK::vector<_T> m_data;
+      size_t m_mask;
+      _ring* m_prev;
+    };
+
+  public:
+    static constexpr size_t default_capacity = 256;
+
+    explicit work_stealing_deque(size_t capacity = default_capacity)
+      : m_ring(new _ring(std::bit_ceil(std::max<size_t>(capacity, 2)), nullptr)) {}
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    ~work_stealing_deque() {
+      _ring* ring = m_ring.load(std::memory_order_relaxed);
+      while (ring) {
+        _ring* prev = ring->m_prev;
+        delete ring;
+        ring = prev;
+      }
+    }
+
+    // Approximate when called while thieves are active
+    [[nodiscard]] size_t size() const noexcept {
+      int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+      int64_t top = m_top.load(std::memory_order_relaxed);
+      return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] size_t capacity() const noexcept { return m_ring.load(std::memory_order_relaxed)->capacity(); }
+
+    // Owner only
+    void push(_T item) {
+      int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+      int64_t top = m_top.load(std::memory_order_acquire);
+      _ring* ring = m_ring.load(std::memory_order_relaxed);
+      if (bottom - top > static_cast<int64_t>(ring->capacity()) - 1) {
+        ring = _grow(ring, bottom, top);
+      }
+      ring->store(bottom, item);
+      m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    // Owner only. Takes the most recently pushed element
+    bool try_pop(_T& out) noexcept {
+      int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+      _ring* ring = m_ring.load(std::memory_order_relaxed);
+      m_bottom.store(bottom, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t top = m_top.load(std::memory_order_relaxed);
+
+      if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+      }
+
+      out = ring->load(bottom);
+      if (top == bottom) {
+        // Last element, race the thieves for it
+        bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+      }
+      return true;
+    }
+
+    // Any thread. Takes the oldest element; fails spuriously under contention
+    bool try_steal(_T& out) noexcept {
+      int64_t top = m_top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+      if (top >= bottom) {
+        return false;
+      }
+
+      _ring* ring = m_ring.load(std::memory_order_acquire);
+      _T item = ring->load(top);
+      if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;
+      }
+      out = item;
+      return true;
+    }
+
+  private:
+    _ring* _grow(_ring* ring, int64_t bottom, int64_t top) {
+      _ring* grown = new _ring(ring->capacity() * 2, ring);
+      for (int64_t i = top; i < bottom; ++i) {
+        grown->store(i, ring->load(i));
+      }
+      m_ring.store(grown, std::memory_order_release);
+      return grown;
+    }
+
+    alignas(JMK::cache_line_size) std::atomic<int64_t> m_top = 0;
+    alignas(JMK::cache_line_size) std::atomic<int64_t> m_bottom = 0;
+    alignas(JMK::cache_line_size) std::atomic<_ring*> m_ring;
+  };
+
+}